@@ -0,0 +1,35 @@
+// Copyright 2024 Keys
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <string>
+
+#include "alloc_shim/alloc_shim.hpp"
+#include "utils/utils.hpp"
+
+bool ParseAllocReport(const std::string& report, AllocStats* stats) {
+  return sscanf(report.c_str(),
+                "allocs=%" SCNu64 " frees=%" SCNu64 " bytes=%" SCNu64
+                " peak=%" SCNu64 " hwm=%" SCNu64,
+                &stats->allocations, &stats->frees, &stats->bytes,
+                &stats->peak_live, &stats->peak_rss) == 5;
+}
+
+std::string FindAllocShim() {
+  if (GetEnvLong("LEETVIEWER_NO_ALLOC_SHIM", 0) != 0) {
+    return "";
+  }
+  std::string path = GetEnvOr("LEETVIEWER_ALLOC_SHIM", "");
+  if (path.empty()) {
+    char exe[4096];
+    ssize_t length = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    if (length <= 0) {
+      return "";
+    }
+    std::string exe_path(exe, length);
+    path = exe_path.substr(0, exe_path.find_last_of('/')) +
+           "/libleetviewer_alloc.so";
+  }
+  return access(path.c_str(), R_OK) == 0 ? path : "";
+}
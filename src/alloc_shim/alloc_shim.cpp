@@ -0,0 +1,165 @@
+// Copyright 2024 Keys
+//
+// LD_PRELOAD library that counts heap activity of a solution run. It wraps
+// the malloc family around glibc's __libc_* entry points (which avoids the
+// dlsym bootstrapping problem) and reports totals through the file
+// descriptor named by kAllocReportFdEnv when the program exits. Sizes are
+// measured with malloc_usable_size so frees balance allocations exactly.
+#include <fcntl.h>
+#include <malloc.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "alloc_shim/alloc_shim.hpp"
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocations{0};
+std::atomic<std::uint64_t> g_frees{0};
+std::atomic<std::uint64_t> g_bytes{0};
+std::atomic<std::uint64_t> g_live{0};
+std::atomic<std::uint64_t> g_peak_live{0};
+
+void RecordAlloc(void* ptr) {
+  if (ptr == nullptr) return;
+  std::uint64_t size = malloc_usable_size(ptr);
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_bytes.fetch_add(size, std::memory_order_relaxed);
+  std::uint64_t live =
+      g_live.fetch_add(size, std::memory_order_relaxed) + size;
+  std::uint64_t peak = g_peak_live.load(std::memory_order_relaxed);
+  while (live > peak && !g_peak_live.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+// Blocks can reach free() without passing through the wrappers (glibc
+// allocates internally for strdup, getline and the like), so the live
+// total is clamped at zero instead of wrapping around
+void SubtractLive(std::uint64_t size) {
+  std::uint64_t live = g_live.load(std::memory_order_relaxed);
+  while (!g_live.compare_exchange_weak(live, live > size ? live - size : 0,
+                                       std::memory_order_relaxed)) {
+  }
+}
+
+void RecordFree(void* ptr) {
+  if (ptr == nullptr) return;
+  g_frees.fetch_add(1, std::memory_order_relaxed);
+  SubtractLive(malloc_usable_size(ptr));
+}
+
+// VmHWM from /proc/self/status, read without touching the heap.
+std::uint64_t PeakRssBytes() {
+  char status[4096];
+  int fd = open("/proc/self/status", O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return 0;
+  ssize_t length = read(fd, status, sizeof(status) - 1);
+  close(fd);
+  if (length <= 0) return 0;
+  status[length] = '\0';
+  const char* field = strstr(status, "VmHWM:");
+  return field ? strtoull(field + 6, nullptr, 10) * 1024 : 0;
+}
+
+__attribute__((destructor)) void WriteReport() {
+  const char* fd_text = getenv(kAllocReportFdEnv);
+  if (fd_text == nullptr) return;
+
+  AllocStats stats;
+  stats.allocations = g_allocations.load();
+  stats.frees = g_frees.load();
+  stats.bytes = g_bytes.load();
+  stats.peak_live = g_peak_live.load();
+  stats.peak_rss = PeakRssBytes();
+  char report[160];
+  int length = FormatAllocReport(stats, report, sizeof(report));
+  if (length > 0) {
+    ssize_t ignored = write(atoi(fd_text), report, length);
+    (void)ignored;
+  }
+}
+
+}  // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+  void* ptr = __libc_malloc(size);
+  RecordAlloc(ptr);
+  return ptr;
+}
+
+void* calloc(size_t count, size_t size) {
+  void* ptr = __libc_calloc(count, size);
+  RecordAlloc(ptr);
+  return ptr;
+}
+
+void* realloc(void* ptr, size_t size) {
+  if (ptr == nullptr) return malloc(size);
+  std::uint64_t old_size = malloc_usable_size(ptr);
+  void* moved = __libc_realloc(ptr, size);
+  if (moved == nullptr) {
+    if (size == 0) {  // realloc(ptr, 0) freed the block
+      g_frees.fetch_add(1, std::memory_order_relaxed);
+      SubtractLive(old_size);
+    }
+    return nullptr;
+  }
+  g_frees.fetch_add(1, std::memory_order_relaxed);
+  SubtractLive(old_size);
+  RecordAlloc(moved);
+  return moved;
+}
+
+void free(void* ptr) {
+  RecordFree(ptr);
+  __libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size) {
+  void* ptr = __libc_memalign(alignment, size);
+  RecordAlloc(ptr);
+  return ptr;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+  return memalign(alignment, size);
+}
+
+void* valloc(size_t size) {
+  return memalign(sysconf(_SC_PAGESIZE), size);
+}
+
+void* pvalloc(size_t size) {
+  size_t page = sysconf(_SC_PAGESIZE);
+  size = std::max<size_t>(size, 1);  // pvalloc(0) still gets a page
+  return memalign(page, (size + page - 1) / page * page);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+  if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  void* ptr = memalign(alignment, size);
+  if (ptr == nullptr) return ENOMEM;
+  *out = ptr;
+  return 0;
+}
+
+}  // extern "C"
@@ -0,0 +1,40 @@
+// Copyright 2024 Keys
+#ifndef SRC_ALLOC_SHIM_ALLOC_SHIM_HPP_
+#define SRC_ALLOC_SHIM_ALLOC_SHIM_HPP_
+
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Protocol between the runner and the allocation-counting shim
+// (libleetviewer_alloc.so), which is LD_PRELOADed into solution runs. When
+// kAllocReportFdEnv names a file descriptor, the shim writes one report line
+// to it as the program exits.
+constexpr char kAllocReportFdEnv[] = "LEETVIEWER_ALLOC_FD";
+
+struct AllocStats {
+  std::uint64_t allocations = 0;
+  std::uint64_t frees = 0;
+  std::uint64_t bytes = 0;       // Total bytes handed out by malloc & co.
+  std::uint64_t peak_live = 0;   // Largest number of bytes live at once
+  std::uint64_t peak_rss = 0;    // VmHWM of the program's own address space
+};
+
+// Formats without allocating, since the shim reports during process teardown.
+inline int FormatAllocReport(const AllocStats& stats, char* buffer,
+                             size_t size) {
+  return snprintf(buffer, size,
+                  "allocs=%" PRIu64 " frees=%" PRIu64 " bytes=%" PRIu64
+                  " peak=%" PRIu64 " hwm=%" PRIu64 "\n",
+                  stats.allocations, stats.frees, stats.bytes,
+                  stats.peak_live, stats.peak_rss);
+}
+
+bool ParseAllocReport(const std::string& report, AllocStats* stats);
+
+// Path of the shim library: LEETVIEWER_ALLOC_SHIM, else next to the
+// executable. Empty if it is missing or LEETVIEWER_NO_ALLOC_SHIM is set.
+std::string FindAllocShim();
+
+#endif  // SRC_ALLOC_SHIM_ALLOC_SHIM_HPP_
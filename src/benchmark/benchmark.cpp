@@ -0,0 +1,165 @@
+// Copyright 2024 Keys
+#include "benchmark/benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <vector>
+
+#include "build_profile/build_profile.hpp"
+#include "compile_cache/compile_cache.hpp"
+#include "runner/runner.hpp"
+#include "utils/utils.hpp"
+
+namespace {
+
+// Linear interpolation between closest ranks of a sorted sample.
+double Percentile(const std::vector<double>& sorted, double fraction) {
+  if (sorted.empty()) return 0;
+  double rank = fraction * (sorted.size() - 1);
+  size_t lower = static_cast<size_t>(rank);
+  size_t upper = std::min(lower + 1, sorted.size() - 1);
+  return sorted[lower] + (sorted[upper] - sorted[lower]) * (rank - lower);
+}
+
+}  // namespace
+
+BenchmarkOptions DefaultBenchmarkOptions() {
+  BenchmarkOptions options;
+  options.warmup_runs =
+      std::max(0L, GetEnvLong("LEETVIEWER_BENCH_WARMUP", options.warmup_runs));
+  options.repetitions =
+      std::max(1L, GetEnvLong("LEETVIEWER_BENCH_RUNS", options.repetitions));
+  return options;
+}
+
+BenchmarkStats ComputeStats(std::vector<double> samples) {
+  BenchmarkStats stats;
+  if (samples.empty()) return stats;
+  std::sort(samples.begin(), samples.end());
+
+  stats.samples = samples.size();
+  stats.min_ns = samples.front();
+  stats.median_ns = Percentile(samples, 0.5);
+  stats.p95_ns = Percentile(samples, 0.95);
+  stats.p99_ns = Percentile(samples, 0.99);
+
+  double sum = 0;
+  for (double sample : samples) sum += sample;
+  stats.mean_ns = sum / samples.size();
+
+  if (samples.size() > 1) {
+    double squares = 0;
+    for (double sample : samples) {
+      squares += (sample - stats.mean_ns) * (sample - stats.mean_ns);
+    }
+    stats.stddev_ns = std::sqrt(squares / (samples.size() - 1));
+  }
+  return stats;
+}
+
+bool RunBenchmark(const std::string& binary_path,
+                  const BenchmarkOptions& options, BenchmarkStats* stats,
+                  std::string* error, const BenchmarkProgress& progress,
+                  const std::atomic<bool>* cancel) {
+  int total = options.warmup_runs + options.repetitions;
+  ProcessOptions run_options;
+  run_options.on_stdout = [](const std::string&) {};  // Discard output
+  run_options.cancel = cancel;
+  std::vector<double> samples;
+  samples.reserve(options.repetitions);
+
+  for (int run = 0; run < total; ++run) {
+    if (cancel != nullptr && cancel->load()) {
+      *error = "Benchmark cancelled";
+      return false;
+    }
+    ProcessResult result = RunBinary(binary_path, run_options);
+    if (!result.Succeeded()) {
+      *error = "Run " + std::to_string(run + 1) + " failed (" +
+               DescribeExitStatus(result) + ")";
+      return false;
+    }
+    if (run >= options.warmup_runs) {
+      samples.push_back(static_cast<double>(result.wall_ns));
+    }
+    if (progress) progress(run + 1, total);
+  }
+
+  *stats = ComputeStats(samples);
+  return true;
+}
+
+double EmptyProcessBaselineNs(const BenchmarkOptions& options) {
+  static std::mutex mutex;
+  static bool measured = false;
+  static double baseline_ns = 0;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  if (measured) return baseline_ns;
+  measured = true;
+
+  std::string dir = GetCacheRoot() + "/baseline";
+  std::string source_path = dir + "/empty_main.cpp";
+  if (!MakeDirectories(dir)) return 0;
+  {
+    std::ofstream source(source_path, std::ios::trunc);
+    source << "int main() { return 0; }\n";
+  }
+
+  std::string binary_path, diagnostics, error;
+  BenchmarkStats stats;
+  if (CompileCppFile(source_path, ActiveBuildProfile(), &binary_path,
+                     &diagnostics) &&
+      RunBenchmark(binary_path, options, &stats, &error)) {
+    baseline_ns = stats.median_ns;
+  }
+  return baseline_ns;
+}
+
+std::string FormatNanoseconds(double ns) {
+  char buffer[32];
+  if (ns < 1e3) {
+    snprintf(buffer, sizeof(buffer), "%.0f ns", ns);
+  } else if (ns < 1e6) {
+    snprintf(buffer, sizeof(buffer), "%.2f us", ns / 1e3);
+  } else if (ns < 1e9) {
+    snprintf(buffer, sizeof(buffer), "%.2f ms", ns / 1e6);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%.2f s", ns / 1e9);
+  }
+  return buffer;
+}
+
+std::string FormatBenchmarkTable(const BenchmarkStats& stats,
+                                 const BenchmarkOptions& options) {
+  const struct {
+    const char* label;
+    double value;
+  } rows[] = {{"min", stats.min_ns},   {"median", stats.median_ns},
+              {"mean", stats.mean_ns}, {"p95", stats.p95_ns},
+              {"p99", stats.p99_ns}};
+
+  std::string table = "Benchmark: " + std::to_string(stats.samples) +
+                      " runs after " + std::to_string(options.warmup_runs) +
+                      " warm-up\n";
+  char line[96];
+  snprintf(line, sizeof(line), "  %-8s %12s %12s\n", "", "raw", "net");
+  table += line;
+  for (const auto& row : rows) {
+    snprintf(line, sizeof(line), "  %-8s %12s %12s\n", row.label,
+             FormatNanoseconds(row.value).c_str(),
+             FormatNanoseconds(stats.Net(row.value)).c_str());
+    table += line;
+  }
+  snprintf(line, sizeof(line), "  %-8s %12s\n", "stddev",
+           FormatNanoseconds(stats.stddev_ns).c_str());
+  table += line;
+  snprintf(line, sizeof(line), "  %-8s %12s (empty process)\n", "baseline",
+           FormatNanoseconds(stats.baseline_ns).c_str());
+  table += line;
+  return table;
+}
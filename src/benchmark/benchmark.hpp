@@ -0,0 +1,57 @@
+// Copyright 2024 Keys
+#ifndef SRC_BENCHMARK_BENCHMARK_HPP_
+#define SRC_BENCHMARK_BENCHMARK_HPP_
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+struct BenchmarkOptions {
+  int warmup_runs = 3;
+  int repetitions = 20;
+};
+
+// Summary of one benchmark. Times are in nanoseconds of child wall time.
+struct BenchmarkStats {
+  int samples = 0;
+  double min_ns = 0;
+  double median_ns = 0;
+  double mean_ns = 0;
+  double p95_ns = 0;
+  double p99_ns = 0;
+  double stddev_ns = 0;
+  // Median wall time of an empty process, subtracted by Net().
+  double baseline_ns = 0;
+
+  double Net(double ns) const { return ns > baseline_ns ? ns - baseline_ns : 0; }
+};
+
+// Called after every timed or warm-up run with (completed, total).
+using BenchmarkProgress = std::function<void(int done, int total)>;
+
+// Options from LEETVIEWER_BENCH_WARMUP and LEETVIEWER_BENCH_RUNS.
+BenchmarkOptions DefaultBenchmarkOptions();
+
+// Order statistics, mean and sample standard deviation of `samples`.
+BenchmarkStats ComputeStats(std::vector<double> samples);
+
+// Runs `binary_path` warmup_runs + repetitions times with output discarded
+// and summarises the timed runs. Fails if any run does not exit cleanly.
+bool RunBenchmark(const std::string& binary_path,
+                  const BenchmarkOptions& options, BenchmarkStats* stats,
+                  std::string* error, const BenchmarkProgress& progress = {},
+                  const std::atomic<bool>* cancel = nullptr);
+
+// Median wall time of a compiled empty `main`, measured once per process
+// with the same options. Returns 0 if it cannot be built.
+double EmptyProcessBaselineNs(const BenchmarkOptions& options);
+
+// Small fixed-width table for the output pane.
+std::string FormatBenchmarkTable(const BenchmarkStats& stats,
+                                 const BenchmarkOptions& options);
+
+// "812 ns", "1.25 ms", "2.10 s".
+std::string FormatNanoseconds(double ns);
+
+#endif  // SRC_BENCHMARK_BENCHMARK_HPP_
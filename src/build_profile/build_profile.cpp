@@ -0,0 +1,106 @@
+// Copyright 2024 Keys
+#include "build_profile/build_profile.hpp"
+
+#include <glob.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <mutex>  // NOLINT [build/c++11]
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "utils/utils.hpp"
+
+namespace {
+
+bool IsInstalled(const std::string& program) {
+  std::istringstream path(GetEnvOr("PATH", "/usr/bin:/bin"));
+  std::string dir;
+  while (std::getline(path, dir, ':')) {
+    if (!dir.empty() && access((dir + "/" + program).c_str(), X_OK) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool HasLibcxxHeaders() {
+  const char* patterns[] = {"/usr/include/c++/v1/vector",
+                            "/usr/local/include/c++/v1/vector",
+                            "/usr/lib/llvm-*/include/c++/v1/vector"};
+  for (const char* pattern : patterns) {
+    glob_t matches;
+    bool found = glob(pattern, 0, nullptr, &matches) == 0;
+    globfree(&matches);
+    if (found) return true;
+  }
+  return false;
+}
+
+std::vector<BuildProfile> DetectProfiles() {
+  const std::vector<std::vector<std::string>> levels = {
+      {"-O0"}, {"-O2"}, {"-O3"}, {"-O3", "-march=native"}};
+
+  std::vector<BuildProfile> profiles;
+  for (const std::string compiler : {"clang++", "g++"}) {
+    if (!IsInstalled(compiler)) continue;
+    for (const std::vector<std::string>& flags : levels) {
+      std::string name = compiler;
+      for (const std::string& flag : flags) name += " " + flag;
+      profiles.push_back({name, compiler, flags});
+    }
+    if (compiler == "clang++" && HasLibcxxHeaders()) {
+      profiles.push_back(
+          {"clang++ -O2 libc++", compiler, {"-O2", "-stdlib=libc++"}});
+    }
+  }
+  return profiles;
+}
+
+const BuildProfile* FindProfile(const std::string& name) {
+  for (const BuildProfile& profile : BuildProfiles()) {
+    if (profile.name == name) return &profile;
+  }
+  return nullptr;
+}
+
+// Read by the run, prefetch and comparison workers while the UI cycles it
+std::atomic<size_t> g_active_index{0};
+std::once_flag g_active_resolved;
+
+}  // namespace
+
+const std::vector<BuildProfile>& BuildProfiles() {
+  static const std::vector<BuildProfile> profiles = DetectProfiles();
+  return profiles;
+}
+
+const BuildProfile& ActiveBuildProfile() {
+  static const BuildProfile fallback = {"clang++", "clang++", {}};
+  const std::vector<BuildProfile>& profiles = BuildProfiles();
+  if (profiles.empty()) return fallback;
+
+  std::call_once(g_active_resolved, [&]() {
+    const BuildProfile* chosen =
+        FindProfile(GetEnvOr("LEETVIEWER_PROFILE", ""));
+    g_active_index = chosen ? chosen - profiles.data() : 0;
+  });
+  return profiles[g_active_index % profiles.size()];
+}
+
+void CycleActiveBuildProfile() {
+  const std::vector<BuildProfile>& profiles = BuildProfiles();
+  if (profiles.empty()) return;
+  ActiveBuildProfile();  // Make sure the index is resolved
+  size_t index = g_active_index;
+  while (!g_active_index.compare_exchange_weak(
+      index, (index + 1) % profiles.size())) {
+  }
+}
+
+const BuildProfile& BaselineBuildProfile() {
+  const BuildProfile* chosen =
+      FindProfile(GetEnvOr("LEETVIEWER_BASELINE_PROFILE", ""));
+  return chosen ? *chosen : ActiveBuildProfile();
+}
@@ -0,0 +1,31 @@
+// Copyright 2024 Keys
+#ifndef SRC_BUILD_PROFILE_BUILD_PROFILE_HPP_
+#define SRC_BUILD_PROFILE_BUILD_PROFILE_HPP_
+
+#include <string>
+#include <vector>
+
+// A compiler plus the flags solutions are built with, e.g. "g++ -O2".
+struct BuildProfile {
+  std::string name;
+  std::string compiler;
+  std::vector<std::string> flags;
+};
+
+// Every profile whose compiler is installed: clang++ and g++ at -O0, -O2,
+// -O3 and -O3 -march=native, plus clang++ with libc++ when its headers are
+// present. Computed once per process.
+const std::vector<BuildProfile>& BuildProfiles();
+
+// Profile for normal runs: LEETVIEWER_PROFILE by name, else the first
+// installed one. Falls back to plain clang++ if no compiler was found.
+const BuildProfile& ActiveBuildProfile();
+
+// Switches normal runs to the next profile in BuildProfiles().
+void CycleActiveBuildProfile();
+
+// Reference for matrix speedups: LEETVIEWER_BASELINE_PROFILE, else the
+// active profile.
+const BuildProfile& BaselineBuildProfile();
+
+#endif  // SRC_BUILD_PROFILE_BUILD_PROFILE_HPP_
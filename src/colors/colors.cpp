@@ -20,4 +20,8 @@ void InitColors() {
   init_pair(8, COLOR_MAGENTA, COLOR_WHITE);  // Magenta text (for strings)
   init_pair(9, COLOR_GREEN, COLOR_WHITE);    // Green text (for comments)
   init_pair(10, COLOR_CYAN, COLOR_WHITE);    // Cyan text (for numbers)
+  init_pair(11, COLOR_BLUE, COLOR_WHITE);     // Blue text (for types)
+  init_pair(12, COLOR_RED, COLOR_WHITE);      // Red text (for control flow)
+  init_pair(13, COLOR_MAGENTA, COLOR_WHITE);  // Magenta text (preprocessor)
+  init_pair(14, COLOR_CYAN, COLOR_WHITE);     // Cyan text (standard library)
 }
@@ -0,0 +1,229 @@
+// Copyright 2024 Keys
+#include "comparison/comparison.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>  // NOLINT [build/c++11]
+#include <vector>
+
+#include "hash/hash.hpp"
+#include "runner/runner.hpp"
+#include "utils/utils.hpp"
+
+namespace {
+
+bool Cancelled(const std::atomic<bool>* cancel) {
+  return cancel != nullptr && cancel->load();
+}
+
+// Compiles all candidates with a small pool of workers pulling from a shared
+// index; `binaries[i]` is left empty for candidates that failed.
+void CompileAll(const std::vector<Candidate>& candidates,
+                std::vector<CandidateResult>* results,
+                std::vector<std::string>* binaries,
+                const ComparisonProgress& progress,
+                const std::atomic<bool>* cancel) {
+  size_t count = results->size();
+  std::atomic<size_t> next{0};
+  std::atomic<size_t> done{0};
+  unsigned workers = std::max(1u, std::thread::hardware_concurrency());
+  workers = std::min<unsigned>(workers, count);
+
+  std::vector<std::thread> pool;
+  for (unsigned w = 0; w < workers; ++w) {
+    pool.emplace_back([&]() {
+      for (size_t i = next++; i < count && !Cancelled(cancel); i = next++) {
+        CandidateResult& result = (*results)[i];
+        std::string diagnostics;
+        result.compiled =
+            CompileCppFile(candidates[i].cpp_file_path, candidates[i].profile,
+                           &(*binaries)[i], &diagnostics, cancel);
+        if (!result.compiled) {
+          (*binaries)[i].clear();
+          result.error = "compile failed";
+        }
+        size_t finished = ++done;
+        if (progress) {
+          progress("compiling " + std::to_string(finished) + "/" +
+                   std::to_string(count));
+        }
+      }
+    });
+  }
+  for (std::thread& worker : pool) {
+    worker.join();
+  }
+}
+
+bool FasterThan(const CandidateResult& a, const CandidateResult& b) {
+  if (a.benchmarked != b.benchmarked) return a.benchmarked;
+  if (!a.benchmarked) return a.label < b.label;
+  return a.stats.Net(a.stats.median_ns) < b.stats.Net(b.stats.median_ns);
+}
+
+}  // namespace
+
+std::vector<CandidateResult> CompareCandidates(
+    const std::vector<Candidate>& candidates, const BenchmarkOptions& options,
+    const ComparisonProgress& progress, const std::atomic<bool>* cancel) {
+  std::vector<CandidateResult> results(candidates.size());
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    results[i].label = candidates[i].label;
+  }
+  std::vector<std::string> binaries(candidates.size());
+  CompileAll(candidates, &results, &binaries, progress, cancel);
+
+  if (progress) progress("measuring baseline");
+  double baseline_ns = EmptyProcessBaselineNs(options);
+
+  std::map<std::uint64_t, int> output_votes;
+  for (size_t i = 0; i < results.size() && !Cancelled(cancel); ++i) {
+    CandidateResult& result = results[i];
+    if (!result.compiled) continue;
+
+    // One reference run hashes stdout as it streams for comparison and,
+    // through the allocation shim, records the program's own peak RSS
+    Hasher output_hasher;
+    ProcessOptions run_options;
+    run_options.on_stdout = [&](const std::string& chunk) {
+      output_hasher.Update(chunk);
+    };
+    run_options.cancel = cancel;
+    ProcessResult reference = RunBinary(binaries[i], run_options, true);
+    if (!reference.Succeeded()) {
+      result.error = DescribeExitStatus(reference);
+      continue;
+    }
+    result.output_hash = output_hasher.Digest();
+    result.peak_rss_bytes = reference.peak_rss_bytes;
+    result.peak_rss_exact = reference.peak_rss_exact;
+    output_votes[result.output_hash]++;
+
+    auto on_progress = [&](int done, int total) {
+      if (progress) {
+        progress(result.label + " " + std::to_string(done) + "/" +
+                 std::to_string(total));
+      }
+    };
+    result.benchmarked = RunBenchmark(binaries[i], options, &result.stats,
+                                      &result.error, on_progress, cancel);
+    result.stats.baseline_ns = baseline_ns;
+  }
+
+  // The output more than half of the candidates agree on is taken as the
+  // reference; without one, no candidate can be called right or wrong
+  int total_votes = 0;
+  for (const auto& vote : output_votes) total_votes += vote.second;
+  bool has_majority = false;
+  std::uint64_t majority_hash = 0;
+  for (const auto& vote : output_votes) {
+    if (vote.second * 2 > total_votes) {
+      has_majority = true;
+      majority_hash = vote.first;
+    }
+  }
+  for (CandidateResult& result : results) {
+    if (!result.benchmarked) {
+      result.output = OutputAgreement::kDiff;
+    } else if (has_majority) {
+      result.output = result.output_hash == majority_hash
+                          ? OutputAgreement::kMatch
+                          : OutputAgreement::kDiff;
+    }
+  }
+
+  std::stable_sort(results.begin(), results.end(), FasterThan);
+  return results;
+}
+
+std::vector<CandidateResult> CompareApproaches(
+    const std::string& problem_dir, const std::vector<std::string>& files,
+    const BenchmarkOptions& options, const ComparisonProgress& progress,
+    const std::atomic<bool>* cancel) {
+  std::vector<Candidate> candidates;
+  for (const std::string& file : files) {
+    candidates.push_back({file.substr(0, file.rfind('.')),
+                          problem_dir + "/" + file, ActiveBuildProfile()});
+  }
+  return CompareCandidates(candidates, options, progress, cancel);
+}
+
+std::vector<CandidateResult> CompareProfiles(
+    const std::string& cpp_file_path, const BenchmarkOptions& options,
+    const ComparisonProgress& progress, const std::atomic<bool>* cancel) {
+  std::vector<Candidate> candidates;
+  for (const BuildProfile& profile : BuildProfiles()) {
+    candidates.push_back({profile.name, cpp_file_path, profile});
+  }
+  return CompareCandidates(candidates, options, progress, cancel);
+}
+
+std::string FormatComparisonTable(const std::vector<CandidateResult>& results,
+                                  const BenchmarkOptions& options,
+                                  const std::string& title,
+                                  const std::string& baseline_label) {
+  std::string table = title + " (" + std::to_string(options.repetitions) +
+                      " runs after " + std::to_string(options.warmup_runs) +
+                      " warm-up, net of empty process)\n";
+
+  // Speedups are relative to the baseline row, if it produced a timing
+  double baseline_ns = 0;
+  for (const CandidateResult& result : results) {
+    if (result.benchmarked && result.label == baseline_label) {
+      baseline_ns = result.stats.Net(result.stats.median_ns);
+    }
+  }
+  if (!baseline_label.empty()) {
+    table += "Speedup relative to " + baseline_label +
+             (baseline_ns > 0 ? "" : " (no timing, showing vs best)") + "\n";
+  }
+
+  char line[160];
+  snprintf(line, sizeof(line), " %-2s %-28s %10s %10s %8s %10s %6s\n", "#",
+           baseline_label.empty() ? "approach" : "profile", "median", "p95",
+           baseline_ns > 0 ? "speedup" : "vs best", "peak RSS", "output");
+  table += line;
+
+  double best_ns = 0;
+  int rank = 0;
+  for (const CandidateResult& result : results) {
+    std::string name = result.label;
+    if (name.size() > 28) name = name.substr(0, 25) + "...";
+    if (!result.benchmarked) {
+      snprintf(line, sizeof(line), " %-2s %-28s %s\n", "-", name.c_str(),
+               result.error.c_str());
+      table += line;
+      continue;
+    }
+
+    double median_ns = result.stats.Net(result.stats.median_ns);
+    if (rank == 0) best_ns = median_ns;
+    // A net median of 0 is below the empty-process floor, so no ratio
+    // against it means anything
+    char relative[16] = "-";
+    if (baseline_ns > 0) {
+      if (median_ns > 0) {
+        snprintf(relative, sizeof(relative), "x%.2f", baseline_ns / median_ns);
+      }
+    } else if (best_ns > 0) {
+      snprintf(relative, sizeof(relative), "x%.2f", median_ns / best_ns);
+    } else if (median_ns == best_ns) {
+      snprintf(relative, sizeof(relative), "x1.00");
+    }
+    snprintf(line, sizeof(line), " %-2d %-28s %10s %10s %8s %10s %6s\n",
+             ++rank, name.c_str(), FormatNanoseconds(median_ns).c_str(),
+             FormatNanoseconds(result.stats.Net(result.stats.p95_ns)).c_str(),
+             relative,
+             ((result.peak_rss_exact ? "" : "<=") +
+              FormatBytes(result.peak_rss_bytes))
+                 .c_str(),
+             result.output == OutputAgreement::kMatch  ? "match"
+             : result.output == OutputAgreement::kDiff ? "DIFF"
+                                                       : "?");
+    table += line;
+  }
+  return table;
+}
@@ -0,0 +1,70 @@
+// Copyright 2024 Keys
+#ifndef SRC_COMPARISON_COMPARISON_HPP_
+#define SRC_COMPARISON_COMPARISON_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.hpp"
+#include "build_profile/build_profile.hpp"
+
+// One binary to measure: a source file built with a profile.
+struct Candidate {
+  std::string label;  // Row name in the table
+  std::string cpp_file_path;
+  BuildProfile profile;
+};
+
+// Whether a candidate printed the reference output. kUnknown when no output
+// is shared by a strict majority of the candidates, so there is no
+// reference.
+enum class OutputAgreement { kMatch, kDiff, kUnknown };
+
+// Outcome of one candidate.
+struct CandidateResult {
+  std::string label;
+  bool compiled = false;
+  bool benchmarked = false;
+  std::string error;
+  BenchmarkStats stats;
+  long long peak_rss_bytes = 0;  // NOLINT [runtime/int]
+  bool peak_rss_exact = false;   // Otherwise an upper bound (see rusage)
+  std::uint64_t output_hash = 0;
+  OutputAgreement output = OutputAgreement::kUnknown;
+};
+
+// Receives human-readable progress such as "compiling 2/4".
+using ComparisonProgress = std::function<void(const std::string& progress)>;
+
+// Compiles every candidate concurrently (one worker per core), then
+// benchmarks the binaries one at a time with identical `options` so they do
+// not compete for the CPU. Results come back ranked by net median.
+std::vector<CandidateResult> CompareCandidates(
+    const std::vector<Candidate>& candidates, const BenchmarkOptions& options,
+    const ComparisonProgress& progress = {},
+    const std::atomic<bool>* cancel = nullptr);
+
+// Every approach (file) of `problem_dir`, built with the active profile.
+std::vector<CandidateResult> CompareApproaches(
+    const std::string& problem_dir, const std::vector<std::string>& files,
+    const BenchmarkOptions& options, const ComparisonProgress& progress = {},
+    const std::atomic<bool>* cancel = nullptr);
+
+// One solution built with every installed profile (the profile matrix).
+std::vector<CandidateResult> CompareProfiles(
+    const std::string& cpp_file_path, const BenchmarkOptions& options,
+    const ComparisonProgress& progress = {},
+    const std::atomic<bool>* cancel = nullptr);
+
+// Ranked table of time, memory and output agreement for the output pane.
+// With a `baseline_label` the relative column is the speedup over that row;
+// otherwise it is the slowdown against the fastest row.
+std::string FormatComparisonTable(const std::vector<CandidateResult>& results,
+                                  const BenchmarkOptions& options,
+                                  const std::string& title,
+                                  const std::string& baseline_label = "");
+
+#endif  // SRC_COMPARISON_COMPARISON_HPP_
@@ -0,0 +1,161 @@
+// Copyright 2024 Keys
+#include "compile_cache/compile_cache.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <vector>
+
+#include "hash/hash.hpp"
+#include "process/process.hpp"
+#include "utils/utils.hpp"
+
+namespace {
+
+std::string BinaryDir() { return GetCacheRoot() + "/bin"; }
+
+struct CacheEntry {
+  std::string path;
+  std::uint64_t size;
+  struct timespec mtime;
+};
+
+bool OlderThan(const CacheEntry& a, const CacheEntry& b) {
+  if (a.mtime.tv_sec != b.mtime.tv_sec) return a.mtime.tv_sec < b.mtime.tv_sec;
+  return a.mtime.tv_nsec < b.mtime.tv_nsec;
+}
+
+}  // namespace
+
+std::string GetCacheRoot() {
+  std::string root = GetEnvOr("LEETVIEWER_CACHE_DIR", "");
+  if (root.empty()) {
+    std::string base = GetEnvOr("XDG_CACHE_HOME", "");
+    if (base.empty()) {
+      std::string home = GetEnvOr("HOME", "");
+      base = home.empty() ? "/tmp" : home + "/.cache";
+    }
+    root = base + "/leetviewer";
+  }
+  return root;
+}
+
+std::string CompilerVersion(const std::string& compiler) {
+  static std::mutex mutex;
+  static std::map<std::string, std::string> versions;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = versions.find(compiler);
+  if (it != versions.end()) {
+    return it->second;
+  }
+
+  ProcessResult result = RunProcess({compiler, "--version"});
+  std::string version = result.stdout_data.substr(
+      0, result.stdout_data.find('\n'));
+  versions[compiler] = version;
+  return version;
+}
+
+std::string CompileCacheKey(const std::string& source,
+                            const std::string& compiler,
+                            const std::vector<std::string>& flags) {
+  Hasher hasher;
+  hasher.Update(source.size()).Update(source);
+  hasher.Update(compiler.size()).Update(compiler);
+  std::string version = CompilerVersion(compiler);
+  hasher.Update(version.size()).Update(version);
+  hasher.Update(flags.size());
+  for (const std::string& flag : flags) {
+    hasher.Update(flag.size()).Update(flag);
+  }
+  return ToHex(hasher.Digest());
+}
+
+std::string CompileCachePath(const std::string& key) {
+  return BinaryDir() + "/" + key;
+}
+
+std::string CompileCacheStagingPath(const std::string& key) {
+  static std::atomic<unsigned> counter{0};
+  MakeDirectories(BinaryDir());
+  return CompileCachePath(key) + ".tmp." + std::to_string(getpid()) + "." +
+         std::to_string(counter++);
+}
+
+bool CompileCacheLookup(const std::string& key) {
+  std::string path = CompileCachePath(key);
+  if (access(path.c_str(), X_OK) != 0) {
+    return false;
+  }
+  utimensat(AT_FDCWD, path.c_str(), nullptr, 0);  // Mark as recently used
+  return true;
+}
+
+bool CompileCacheStore(const std::string& key, const std::string& built_path) {
+  if (rename(built_path.c_str(), CompileCachePath(key).c_str()) != 0) {
+    unlink(built_path.c_str());
+    return false;
+  }
+  CompileCacheEvict(CompileCacheMaxBytes(), key);
+  return true;
+}
+
+std::uint64_t CompileCacheMaxBytes() {
+  long megabytes = GetEnvLong("LEETVIEWER_CACHE_MAX_MB", 256);  // NOLINT
+  return static_cast<std::uint64_t>(std::max(megabytes, 1L)) << 20;
+}
+
+void CompileCacheEvict(std::uint64_t max_bytes, const std::string& keep_key) {
+  std::string dir_path = BinaryDir();
+  DIR* dir = opendir(dir_path.c_str());
+  if (dir == nullptr) {
+    return;
+  }
+
+  std::vector<CacheEntry> entries;
+  std::uint64_t total = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    // Staging files belong to in-flight compiles and are never evicted.
+    if (name[0] == '.' || name == keep_key ||
+        name.find(".tmp.") != std::string::npos) {
+      continue;
+    }
+    std::string path = dir_path + "/" + name;
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+      continue;
+    }
+    entries.push_back({path, static_cast<std::uint64_t>(st.st_size),
+                       st.st_mtim});
+    total += st.st_size;
+  }
+  closedir(dir);
+
+  struct stat kept;
+  if (stat(CompileCachePath(keep_key).c_str(), &kept) == 0) {
+    total += kept.st_size;
+  }
+  if (total <= max_bytes) {
+    return;
+  }
+
+  std::sort(entries.begin(), entries.end(), OlderThan);
+  for (const CacheEntry& entry : entries) {
+    if (total <= max_bytes) {
+      break;
+    }
+    if (unlink(entry.path.c_str()) == 0) {
+      total -= entry.size;
+    }
+  }
+}
@@ -0,0 +1,41 @@
+// Copyright 2024 Keys
+#ifndef SRC_COMPILE_CACHE_COMPILE_CACHE_HPP_
+#define SRC_COMPILE_CACHE_COMPILE_CACHE_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Persistent, content-addressed store of compiled solution binaries.
+//
+// Entries live under <cache root>/bin and are keyed by a hash of the source
+// bytes, the compiler path and version, and the compile flags. A hit touches
+// the entry's mtime so that eviction can drop the least recently used
+// binaries once the store grows past its size cap.
+
+// Root directory for LeetViewer's on-disk caches. Honours
+// LEETVIEWER_CACHE_DIR, then XDG_CACHE_HOME, then ~/.cache.
+std::string GetCacheRoot();
+
+// First line of `<compiler> --version`, memoized per compiler.
+std::string CompilerVersion(const std::string& compiler);
+
+std::string CompileCacheKey(const std::string& source,
+                            const std::string& compiler,
+                            const std::vector<std::string>& flags);
+std::string CompileCachePath(const std::string& key);
+
+// Unique scratch path next to the store, suitable as a compiler `-o` target.
+std::string CompileCacheStagingPath(const std::string& key);
+
+// Returns true and refreshes the entry's LRU timestamp if `key` is cached.
+bool CompileCacheLookup(const std::string& key);
+
+// Moves a freshly built binary into the store and evicts old entries.
+bool CompileCacheStore(const std::string& key, const std::string& built_path);
+
+// Size cap in bytes; LEETVIEWER_CACHE_MAX_MB overrides the 256 MB default.
+std::uint64_t CompileCacheMaxBytes();
+void CompileCacheEvict(std::uint64_t max_bytes, const std::string& keep_key);
+
+#endif  // SRC_COMPILE_CACHE_COMPILE_CACHE_HPP_
@@ -0,0 +1,43 @@
+// Copyright 2024 Keys
+#include "compositor/compositor.hpp"
+
+#include <ncurses.h>
+#include <panel.h>
+
+namespace {
+
+Layer* Backdrop() {
+  static Layer* backdrop = [] {
+    Layer* layer = new Layer(LINES, COLS, 0, 0);
+    wbkgd(layer->win(), ' ' | COLOR_PAIR(1) | A_DIM);
+    werase(layer->win());
+    layer->Hide();
+    return layer;
+  }();
+  return backdrop;
+}
+
+}  // namespace
+
+Layer::Layer(int lines, int cols, int y, int x)
+    : win_(newwin(lines, cols, y, x)), panel_(new_panel(win_)) {}
+
+Layer::~Layer() {
+  del_panel(panel_);
+  delwin(win_);
+}
+
+void Layer::Raise() {
+  show_panel(panel_);  // Also moves a visible panel to the top
+}
+
+void Layer::Hide() { hide_panel(panel_); }
+
+void ShowBackdrop() { Backdrop()->Raise(); }
+
+void HideBackdrop() { Backdrop()->Hide(); }
+
+void Compose() {
+  update_panels();
+  doupdate();
+}
@@ -0,0 +1,43 @@
+// Copyright 2024 Keys
+#ifndef SRC_COMPOSITOR_COMPOSITOR_HPP_
+#define SRC_COMPOSITOR_COMPOSITOR_HPP_
+
+#include <ncurses.h>
+#include <panel.h>
+
+// Windows stacked with the ncurses panel library. Every layer keeps its own
+// contents, so opening, hiding or closing a layer over others only updates
+// the cells whose visible content changed; nothing underneath is drawn
+// again. stdscr is the bottom of the stack.
+//
+// Code drawing into layers stages them with wnoutrefresh as usual and ends
+// each frame with Compose().
+class Layer {
+ public:
+  // A new window at the top of the stack.
+  Layer(int lines, int cols, int y, int x);
+  ~Layer();
+
+  Layer(const Layer&) = delete;
+  Layer& operator=(const Layer&) = delete;
+
+  WINDOW* win() const { return win_; }
+  // Shows the layer above everything else.
+  void Raise();
+  void Hide();
+
+ private:
+  WINDOW* win_;
+  PANEL* panel_;
+};
+
+// The dimmed full-screen background behind menus. It is drawn once and kept
+// for the rest of the session.
+void ShowBackdrop();
+void HideBackdrop();
+
+// Restores what hidden or closed layers uncovered, then pushes the frame to
+// the terminal with one doupdate().
+void Compose();
+
+#endif  // SRC_COMPOSITOR_COMPOSITOR_HPP_
@@ -0,0 +1,195 @@
+// Copyright 2024 Keys
+#include "dir_scanner/dir_scanner.hpp"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <chrono>  // NOLINT [build/c++11]
+#include <deque>
+#include <memory>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <thread>  // NOLINT [build/c++11]
+#include <utility>
+#include <vector>
+
+#include "file_handler/file_handler.hpp"
+
+namespace {
+
+// Workers are mostly waiting on the filesystem, so a few more than the
+// cores helps on cold caches
+constexpr unsigned kMaxWorkers = 8;
+
+struct WorkerQueue {
+  std::mutex mutex;
+  std::deque<std::string> dirs;
+};
+
+struct Scan {
+  int root_fd = -1;
+  std::string suffix;
+  const std::function<void(const ScannedDir&)>* on_dir = nullptr;
+  const std::atomic<bool>* cancel = nullptr;
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+  std::atomic<size_t> pending{0};  // Directories queued or being read
+
+  bool cancelled() const { return cancel != nullptr && *cancel; }
+};
+
+#ifdef __linux__
+struct LinuxDirent64 {
+  ino64_t d_ino;
+  off64_t d_off;
+  unsigned short d_reclen;  // NOLINT [runtime/int]
+  unsigned char d_type;
+  char d_name[];
+};
+#endif
+
+// Sorts one entry of the directory open as `dir_fd` into `result->files`
+// or `subdirs`
+void AddEntry(const Scan& scan, int dir_fd, const char* name,
+              unsigned char type, ScannedDir* result,
+              std::vector<std::string>* subdirs) {
+  if (name[0] == '.') return;  // Hidden, or "." and ".."
+  struct stat info;
+  if (type == DT_UNKNOWN) {
+    // Some filesystems leave the type to a stat
+    if (fstatat(dir_fd, name, &info, AT_SYMLINK_NOFOLLOW) != 0) return;
+    type = S_ISDIR(info.st_mode)   ? DT_DIR
+           : S_ISREG(info.st_mode) ? DT_REG
+           : S_ISLNK(info.st_mode) ? DT_LNK
+                                   : DT_UNKNOWN;
+  }
+  if (type == DT_DIR) {
+    subdirs->push_back(name);
+  } else if (HasSuffix(name, scan.suffix)) {
+    // Links count when they lead to a regular file
+    if (type == DT_LNK && (fstatat(dir_fd, name, &info, 0) != 0 ||
+                           !S_ISREG(info.st_mode))) {
+      return;
+    }
+    if (type == DT_REG || type == DT_LNK) result->files.push_back(name);
+  }
+}
+
+void ReadDirectory(const Scan& scan, ScannedDir* result,
+                   std::vector<std::string>* subdirs) {
+  const char* path = result->path.empty() ? "." : result->path.c_str();
+  int fd = openat(scan.root_fd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (fd < 0) return;
+#ifdef __linux__
+  alignas(LinuxDirent64) char buffer[32768];
+  while (true) {
+    long length =  // NOLINT [runtime/int]
+        syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+    if (length <= 0) break;
+    for (long offset = 0; offset < length;) {  // NOLINT [runtime/int]
+      const LinuxDirent64* entry =
+          reinterpret_cast<const LinuxDirent64*>(buffer + offset);
+      offset += entry->d_reclen;
+      AddEntry(scan, fd, entry->d_name, entry->d_type, result, subdirs);
+    }
+  }
+  close(fd);
+#else
+  DIR* dir = fdopendir(fd);
+  if (dir == nullptr) {
+    close(fd);
+    return;
+  }
+  while (struct dirent* entry = readdir(dir)) {
+    AddEntry(scan, fd, entry->d_name, entry->d_type, result, subdirs);
+  }
+  closedir(dir);
+#endif
+}
+
+// Takes the newest directory of worker `self`, or steals the oldest one
+// of another worker
+bool TakeDirectory(Scan* scan, size_t self, std::string* dir) {
+  size_t count = scan->queues.size();
+  for (size_t i = 0; i < count; ++i) {
+    WorkerQueue& queue = *scan->queues[(self + i) % count];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.dirs.empty()) continue;
+    if (i == 0) {
+      *dir = std::move(queue.dirs.back());
+      queue.dirs.pop_back();
+    } else {
+      *dir = std::move(queue.dirs.front());
+      queue.dirs.pop_front();
+    }
+    return true;
+  }
+  return false;
+}
+
+void Work(Scan* scan, size_t self) {
+  int idle = 0;
+  while (scan->pending > 0 && !scan->cancelled()) {
+    ScannedDir result;
+    if (!TakeDirectory(scan, self, &result.path)) {
+      // Others are still reading and may queue more; back off gradually
+      if (++idle < 16) {
+        std::this_thread::yield();
+      } else {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+      }
+      continue;
+    }
+    idle = 0;
+
+    std::vector<std::string> subdirs;
+    ReadDirectory(*scan, &result, &subdirs);
+    std::sort(result.files.begin(), result.files.end());
+    if (!subdirs.empty()) {
+      // Counted before this directory is finished, so `pending` cannot
+      // reach zero while work remains
+      scan->pending += subdirs.size();
+      WorkerQueue& queue = *scan->queues[self];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      for (const std::string& name : subdirs) {
+        queue.dirs.push_back(result.path.empty() ? name
+                                                 : result.path + "/" + name);
+      }
+    }
+    (*scan->on_dir)(result);
+    --scan->pending;
+  }
+}
+
+}  // namespace
+
+void ScanTree(const std::string& root, const std::string& suffix,
+              const std::function<void(const ScannedDir&)>& on_dir,
+              const std::atomic<bool>* cancel) {
+  Scan scan;
+  scan.root_fd = open(root.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (scan.root_fd < 0) return;
+  scan.suffix = suffix;
+  scan.on_dir = &on_dir;
+  scan.cancel = cancel;
+  unsigned workers =
+      std::clamp(std::thread::hardware_concurrency() * 2, 2u, kMaxWorkers);
+  for (unsigned i = 0; i < workers; ++i) {
+    scan.queues.push_back(std::make_unique<WorkerQueue>());
+  }
+  scan.queues[0]->dirs.push_back("");  // The root
+  scan.pending = 1;
+
+  std::vector<std::thread> threads;
+  for (unsigned i = 1; i < workers; ++i) {
+    threads.emplace_back(Work, &scan, i);
+  }
+  Work(&scan, 0);
+  for (std::thread& thread : threads) thread.join();
+  close(scan.root_fd);
+}
@@ -0,0 +1,32 @@
+// Copyright 2024 Keys
+#ifndef SRC_DIR_SCANNER_DIR_SCANNER_HPP_
+#define SRC_DIR_SCANNER_DIR_SCANNER_HPP_
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// One directory as read by ScanTree().
+struct ScannedDir {
+  std::string path;                // Relative to the root; "" is the root
+  std::vector<std::string> files;  // Names ending in the suffix, sorted
+};
+
+// Walks every directory under `root` on a pool of threads and calls
+// `on_dir` for each one as soon as it has been read, from the thread that
+// read it, so `on_dir` must be thread-safe. Returns once all directories
+// have been reported, or soon after `*cancel` becomes true.
+//
+// Each worker keeps its own deque of directories still to read: it takes
+// the newest from its own (depth first, so its deque stays short) and,
+// when that is empty, steals the oldest from another worker's, which tends
+// to be a large unexplored subtree. On Linux directories are read with
+// openat() relative to the root and raw getdents64() calls, and the entry
+// type comes from d_type without a stat. Hidden entries are skipped and
+// symbolic links to directories are not followed, so the walk cannot loop.
+void ScanTree(const std::string& root, const std::string& suffix,
+              const std::function<void(const ScannedDir&)>& on_dir,
+              const std::atomic<bool>* cancel = nullptr);
+
+#endif  // SRC_DIR_SCANNER_DIR_SCANNER_HPP_
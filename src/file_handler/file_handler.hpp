@@ -3,13 +3,15 @@
 #define SRC_FILE_HANDLER_FILE_HANDLER_HPP_
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 std::string GetCurrentWorkingDir();
+// True if `name` ends in `suffix` and has something before it, so
+// "a.cpp" matches ".cpp" but "a.cpp.bak" and ".cpp" do not.
+bool HasSuffix(std::string_view name, std::string_view suffix);
+// Files in `path` whose names end in `extension`.
 std::vector<std::string> ListFiles(const std::string& path,
                                    const std::string& extension);
-std::vector<std::string> ListDirectories(const std::string& path);
-std::string ReadFileContent(const std::string& file_path);
-std::string RunCppFileWithOutput(const std::string& cpp_file_path);
 
 #endif  // SRC_FILE_HANDLER_FILE_HANDLER_HPP_
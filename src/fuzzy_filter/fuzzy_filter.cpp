@@ -0,0 +1,82 @@
+// Copyright 2024 Keys
+#include "fuzzy_filter/fuzzy_filter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int kMatchScore = 1;
+constexpr int kConsecutiveBonus = 5;
+constexpr int kWordStartBonus = 8;
+
+char Lower(char c) {
+  return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+}
+
+// "two_sum", "two sum", "twoSum" and "TwoSum" all start a word at 's'/'S'
+bool StartsWord(std::string_view text, size_t i) {
+  if (i == 0) return true;
+  unsigned char previous = text[i - 1], current = text[i];
+  return !std::isalnum(previous) ||
+         (std::islower(previous) && std::isupper(current));
+}
+
+}  // namespace
+
+int FuzzyScore(std::string_view query, std::string_view text) {
+  if (query.empty()) return 0;
+  int score = 0;
+  size_t next = 0;
+  size_t previous = std::string_view::npos;
+  for (char query_char : query) {
+    char wanted = Lower(query_char);
+    while (next < text.size() && Lower(text[next]) != wanted) ++next;
+    if (next == text.size()) return -1;
+    score += kMatchScore;
+    if (previous != std::string_view::npos && next == previous + 1) {
+      score += kConsecutiveBonus;
+    }
+    if (StartsWord(text, next)) score += kWordStartBonus;
+    previous = next++;
+  }
+  // Favour "sum" over "sum_of_subarray_minimums" when both match as well
+  return score * 256 - static_cast<int>(std::min<size_t>(text.size(), 255));
+}
+
+FuzzyFilter::FuzzyFilter(std::vector<std::string> candidates)
+    : candidates_(std::move(candidates)) {
+  Level all;
+  all.matches.resize(candidates_.size());
+  for (size_t i = 0; i < candidates_.size(); ++i) {
+    all.matches[i] = static_cast<std::uint32_t>(i);
+  }
+  levels_.push_back(std::move(all));
+}
+
+void FuzzyFilter::SetQuery(const std::string& query) {
+  // Back up to the longest earlier query that `query` extends
+  while (levels_.size() > 1 &&
+         query.compare(0, levels_.back().query.size(), levels_.back().query) !=
+             0) {
+    levels_.pop_back();
+  }
+  if (query == levels_.back().query) return;
+
+  std::vector<std::pair<int, std::uint32_t>> scored;
+  scored.reserve(levels_.back().matches.size());
+  for (std::uint32_t index : levels_.back().matches) {
+    int score = FuzzyScore(query, candidates_[index]);
+    if (score >= 0) scored.emplace_back(-score, index);
+  }
+  std::sort(scored.begin(), scored.end());  // Best score, then list order
+
+  Level level;
+  level.query = query;
+  level.matches.reserve(scored.size());
+  for (const auto& entry : scored) level.matches.push_back(entry.second);
+  levels_.push_back(std::move(level));
+}
@@ -0,0 +1,49 @@
+// Copyright 2024 Keys
+#ifndef SRC_FUZZY_FILTER_FUZZY_FILTER_HPP_
+#define SRC_FUZZY_FILTER_FUZZY_FILTER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Scores `text` against `query`, whose characters must all appear in `text`
+// in order (case-insensitively). Higher is better: consecutive characters
+// and characters at the start of a word count extra, and shorter texts win
+// ties. Returns -1 if `query` does not match.
+int FuzzyScore(std::string_view query, std::string_view text);
+
+// Ranks a fixed list of candidates against a query that is typed one key at
+// a time.
+//
+// Every match of a query also matches each of its prefixes, so extending the
+// query only re-scores the candidates that survived the previous one. The
+// result for each typed prefix is kept, which makes backspace free.
+class FuzzyFilter {
+ public:
+  explicit FuzzyFilter(std::vector<std::string> candidates);
+
+  void SetQuery(const std::string& query);
+  const std::string& query() const { return levels_.back().query; }
+
+  // Indices of the matching candidates, best first. An empty query matches
+  // everything in the original order.
+  const std::vector<std::uint32_t>& matches() const {
+    return levels_.back().matches;
+  }
+  const std::string& candidate(size_t index) const {
+    return candidates_[index];
+  }
+  size_t size() const { return candidates_.size(); }
+
+ private:
+  struct Level {
+    std::string query;
+    std::vector<std::uint32_t> matches;
+  };
+
+  std::vector<std::string> candidates_;
+  std::vector<Level> levels_;  // levels_[0] is the empty query
+};
+
+#endif  // SRC_FUZZY_FILTER_FUZZY_FILTER_HPP_
@@ -0,0 +1,34 @@
+// Copyright 2024 Keys
+#include "hash/hash.hpp"
+
+#include <string>
+
+Hasher& Hasher::Update(std::string_view bytes) {
+  for (unsigned char byte : bytes) {
+    state_ ^= byte;
+    state_ *= 0x100000001b3ULL;
+  }
+  return *this;
+}
+
+Hasher& Hasher::Update(std::uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    state_ ^= (value >> (i * 8)) & 0xff;
+    state_ *= 0x100000001b3ULL;
+  }
+  return *this;
+}
+
+std::uint64_t HashBytes(std::string_view bytes) {
+  return Hasher().Update(bytes).Digest();
+}
+
+std::string ToHex(std::uint64_t value) {
+  static const char kDigits[] = "0123456789abcdef";
+  std::string hex(16, '0');
+  for (int i = 15; i >= 0; --i) {
+    hex[i] = kDigits[value & 0xf];
+    value >>= 4;
+  }
+  return hex;
+}
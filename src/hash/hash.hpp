@@ -0,0 +1,23 @@
+// Copyright 2024 Keys
+#ifndef SRC_HASH_HASH_HPP_
+#define SRC_HASH_HASH_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Incremental 64-bit FNV-1a hasher used to content-address files and builds.
+class Hasher {
+ public:
+  Hasher& Update(std::string_view bytes);
+  Hasher& Update(std::uint64_t value);
+  std::uint64_t Digest() const { return state_; }
+
+ private:
+  std::uint64_t state_ = 0xcbf29ce484222325ULL;
+};
+
+std::uint64_t HashBytes(std::string_view bytes);
+std::string ToHex(std::uint64_t value);
+
+#endif  // SRC_HASH_HASH_HPP_
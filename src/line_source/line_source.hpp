@@ -0,0 +1,42 @@
+// Copyright 2024 Keys
+#ifndef SRC_LINE_SOURCE_LINE_SOURCE_HPP_
+#define SRC_LINE_SOURCE_LINE_SOURCE_HPP_
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Read access to numbered lines of text, for views that only ever look at a
+// few of them. Sources may index lazily, so lookups are not const; returned
+// views stay valid until the source is next modified.
+class LineSource {
+ public:
+  virtual ~LineSource() = default;
+
+  // Sets `line` (without its newline) and returns true if line `index`
+  // exists.
+  virtual bool GetLine(size_t index, std::string_view* line) = 0;
+
+  bool HasLine(size_t index) {
+    std::string_view line;
+    return GetLine(index, &line);
+  }
+};
+
+// Lines already split into strings.
+class StringLines : public LineSource {
+ public:
+  explicit StringLines(const std::vector<std::string>* lines)
+      : lines_(lines) {}
+
+  bool GetLine(size_t index, std::string_view* line) override {
+    if (index >= lines_->size()) return false;
+    *line = (*lines_)[index];
+    return true;
+  }
+
+ private:
+  const std::vector<std::string>* lines_;
+};
+
+#endif  // SRC_LINE_SOURCE_LINE_SOURCE_HPP_
@@ -3,8 +3,9 @@
 #include "splash_screen/splash_screen.hpp"
 #include "tui/tui.hpp"
 
-int main() {
-  RenderSplashScreen();
+int main(int argc, char** argv) {
+  TuiSession session;
+  RenderSplashScreen(SplashOptionsFrom(argc, argv));
 
   std::string cpp_folder = GetCurrentWorkingDir();
   TuiSelectAndRun(cpp_folder);
@@ -0,0 +1,130 @@
+// Copyright 2024 Keys
+#include "output_buffer/output_buffer.hpp"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#include "utils/utils.hpp"
+
+namespace {
+
+// Mappings grow in steps of at least this much to keep remaps rare
+constexpr size_t kMinMapBytes = 1 << 20;
+
+}  // namespace
+
+OutputBuffer::OutputBuffer() {
+  std::string path = GetEnvOr("TMPDIR", "/tmp") + "/leetviewer-output-XXXXXX";
+  fd_ = mkstemp(&path[0]);
+  if (fd_ >= 0) {
+    unlink(path.c_str());  // Freed automatically once closed
+  }
+}
+
+OutputBuffer::~OutputBuffer() {
+  if (map_ != nullptr) munmap(map_, mapped_);
+  if (fd_ >= 0) close(fd_);
+}
+
+void OutputBuffer::Append(std::string_view data) {
+  if (fd_ < 0) {
+    fallback_.append(data);
+    size_ += data.size();
+    return;
+  }
+  while (!data.empty()) {
+    ssize_t written = write(fd_, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) continue;
+      return;  // Disk full or similar: keep what was stored
+    }
+    data.remove_prefix(written);
+    size_ += written;
+  }
+  if (size_ > mapped_) {
+    Remap();
+  }
+}
+
+void OutputBuffer::Clear() {
+  if (map_ != nullptr) {
+    munmap(map_, mapped_);
+    map_ = nullptr;
+    mapped_ = 0;
+  }
+  if (fd_ >= 0) {
+    if (ftruncate(fd_, 0) != 0 || lseek(fd_, 0, SEEK_SET) != 0) {
+      close(fd_);
+      fd_ = -1;  // Continue in memory
+    }
+  }
+  fallback_.clear();
+  size_ = 0;
+  line_starts_.assign(1, 0);
+  scanned_ = 0;
+}
+
+const char* OutputBuffer::data() const {
+  return fd_ >= 0 ? map_ : fallback_.data();
+}
+
+std::uint64_t OutputBuffer::readable() const {
+  return fd_ >= 0 ? std::min<std::uint64_t>(size_, mapped_) : size_;
+}
+
+void OutputBuffer::Remap() {
+  // Map past the end of the file so that most appends fit without a remap;
+  // only bytes below size_ are ever read
+  size_t length = std::max<size_t>({size_, mapped_ * 2, kMinMapBytes});
+  void* map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    // Keep the old mapping, so the lines indexed so far stay readable; the
+    // next Append tries again
+    return;
+  }
+  if (map_ != nullptr) munmap(map_, mapped_);
+  map_ = static_cast<char*>(map);
+  mapped_ = length;
+}
+
+void OutputBuffer::IndexUpTo(size_t line) {
+  const char* base = data();
+  if (base == nullptr) return;
+  std::uint64_t end = readable();
+  while (line_starts_.size() <= line && scanned_ < end) {
+    const void* newline = memchr(base + scanned_, '\n', end - scanned_);
+    if (newline == nullptr) {
+      scanned_ = end;
+      break;
+    }
+    scanned_ = static_cast<const char*>(newline) - base + 1;
+    line_starts_.push_back(scanned_);
+  }
+}
+
+bool OutputBuffer::GetLine(size_t index, std::string_view* line) {
+  if (data() == nullptr) return false;  // Never mapped
+  IndexUpTo(index + 1);
+  if (index + 1 < line_starts_.size()) {
+    // A complete line; drop its newline
+    std::uint64_t begin = line_starts_[index];
+    *line = std::string_view(data() + begin,
+                             line_starts_[index + 1] - 1 - begin);
+    return true;
+  }
+  // The unterminated last line, if any
+  if (index + 1 == line_starts_.size() && scanned_ == size_ &&
+      line_starts_.back() < size_) {
+    std::uint64_t begin = line_starts_.back();
+    *line = std::string_view(data() + begin, size_ - begin);
+    return true;
+  }
+  return false;
+}
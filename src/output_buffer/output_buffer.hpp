@@ -0,0 +1,61 @@
+// Copyright 2024 Keys
+#ifndef SRC_OUTPUT_BUFFER_OUTPUT_BUFFER_HPP_
+#define SRC_OUTPUT_BUFFER_OUTPUT_BUFFER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "line_source/line_source.hpp"
+
+// Program output of any size, kept in an unlinked temporary file that is
+// memory-mapped for reading, so the kernel pages it in and out instead of
+// the viewer holding it all in heap memory.
+//
+// Line starts are found lazily with memchr, only as far as the lines that
+// have been asked for; lines are returned as views into the mapping, so
+// nothing is copied per line. Falls back to an in-memory buffer if no
+// temporary file can be created.
+class OutputBuffer : public LineSource {
+ public:
+  OutputBuffer();
+  ~OutputBuffer() override;
+
+  OutputBuffer(const OutputBuffer&) = delete;
+  OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+  // Appends raw output. Invalidates views returned by GetLine().
+  void Append(std::string_view data);
+  // Drops all output.
+  void Clear();
+
+  std::uint64_t size_bytes() const { return size_; }
+  // Lines from this index on may have changed with the last Append; all
+  // lines before it are complete.
+  size_t FirstOpenLine() const { return line_starts_.size() - 1; }
+
+  bool GetLine(size_t index, std::string_view* line) override;
+
+ private:
+  const char* data() const;
+  // Bytes that data() covers: all of them, unless a remap failed and the
+  // mapping lags behind the file.
+  std::uint64_t readable() const;
+  void Remap();
+  void IndexUpTo(size_t line);
+
+  int fd_ = -1;
+  char* map_ = nullptr;
+  size_t mapped_ = 0;
+  std::uint64_t size_ = 0;
+  std::string fallback_;  // Used when fd_ < 0
+
+  // line_starts_[i] is where line i begins; lines up to
+  // line_starts_.size() - 2 are complete. Everything before `scanned_` has
+  // been searched for newlines.
+  std::vector<std::uint64_t> line_starts_{0};
+  std::uint64_t scanned_ = 0;
+};
+
+#endif  // SRC_OUTPUT_BUFFER_OUTPUT_BUFFER_HPP_
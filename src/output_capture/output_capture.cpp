@@ -0,0 +1,101 @@
+// Copyright 2024 Keys
+#include "output_capture/output_capture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "utils/utils.hpp"
+
+namespace {
+
+std::uint64_t MegabytesFromEnv(const char* name, std::uint64_t fallback) {
+  long megabytes = GetEnvLong(name, -1);  // NOLINT [runtime/int]
+  return megabytes < 0 ? fallback : static_cast<std::uint64_t>(megabytes) << 20;
+}
+
+}  // namespace
+
+OutputLimits DefaultOutputLimits() {
+  OutputLimits limits;
+  limits.head_bytes = MegabytesFromEnv("LEETVIEWER_OUTPUT_HEAD_MB",
+                                       limits.head_bytes);
+  limits.tail_bytes = MegabytesFromEnv("LEETVIEWER_OUTPUT_TAIL_MB",
+                                       limits.tail_bytes);
+  limits.kill_bytes = MegabytesFromEnv("LEETVIEWER_OUTPUT_LIMIT_MB",
+                                       limits.kill_bytes);
+  return limits;
+}
+
+size_t RingBuffer::Write(std::string_view data) {
+  if (capacity_ == 0) return data.size();
+  size_t overwritten = 0;
+  if (data.size() >= capacity_) {
+    // Only the last `capacity_` bytes survive
+    overwritten = size_ + data.size() - capacity_;
+    data.remove_prefix(data.size() - capacity_);
+    start_ = 0;
+    size_ = 0;
+  } else if (size_ + data.size() > capacity_) {
+    overwritten = size_ + data.size() - capacity_;
+    start_ = (start_ + overwritten) % capacity_;
+    size_ -= overwritten;
+  }
+  if (data_.empty()) data_.resize(capacity_);
+
+  size_t end = (start_ + size_) % capacity_;
+  size_t first = std::min(data.size(), capacity_ - end);
+  std::memcpy(data_.data() + end, data.data(), first);
+  std::memcpy(data_.data(), data.data() + first, data.size() - first);
+  size_ += data.size();
+  return overwritten;
+}
+
+std::string RingBuffer::Contents() const {
+  std::string contents;
+  contents.reserve(size_);
+  size_t first = std::min(size_, capacity_ - start_);
+  contents.append(data_.data() + start_, first);
+  contents.append(data_.data(), size_ - first);
+  return contents;
+}
+
+OutputCapture::OutputCapture(const OutputLimits& limits, Sink sink)
+    : limits_(limits), sink_(std::move(sink)), tail_(limits.tail_bytes) {}
+
+void OutputCapture::Write(std::string_view data) {
+  total_ += data.size();
+  if (limits_.head_bytes == 0 || head_ < limits_.head_bytes) {
+    size_t take = data.size();
+    if (limits_.head_bytes != 0) {
+      take = std::min<std::uint64_t>(take, limits_.head_bytes - head_);
+    }
+    if (take > 0) {
+      sink_(std::string(data.substr(0, take)));
+      head_ += take;
+      head_ends_line_ = data[take - 1] == '\n';
+      data.remove_prefix(take);
+    }
+  }
+  if (!data.empty()) {
+    dropped_ += tail_.Write(data);
+  }
+}
+
+void OutputCapture::Finish() {
+  if (tail_.size() == 0) return;
+  std::string tail = tail_.Contents();
+  if (dropped_ > 0) {
+    // The tail starts mid-line after anything was dropped
+    size_t newline = tail.find('\n');
+    if (newline != std::string::npos && newline + 1 < tail.size()) {
+      dropped_ += newline + 1;
+      tail.erase(0, newline + 1);
+    }
+    sink_(std::string(head_ends_line_ ? "" : "\n") + "[... " +
+          FormatBytes(static_cast<double>(dropped_)) +
+          " of output dropped ...]\n");
+  }
+  sink_(tail);
+}
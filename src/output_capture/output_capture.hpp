@@ -0,0 +1,73 @@
+// Copyright 2024 Keys
+#ifndef SRC_OUTPUT_CAPTURE_OUTPUT_CAPTURE_HPP_
+#define SRC_OUTPUT_CAPTURE_OUTPUT_CAPTURE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// How much of a program's output is kept. Sizes in bytes; 0 disables the
+// corresponding cap.
+struct OutputLimits {
+  std::uint64_t head_bytes = 64ULL << 20;
+  std::uint64_t tail_bytes = 4ULL << 20;
+  // The program is killed once it has written this much.
+  std::uint64_t kill_bytes = 1ULL << 30;
+};
+
+// Defaults overridden by LEETVIEWER_OUTPUT_HEAD_MB, LEETVIEWER_OUTPUT_TAIL_MB
+// and LEETVIEWER_OUTPUT_LIMIT_MB.
+OutputLimits DefaultOutputLimits();
+
+// Fixed-capacity byte ring that keeps the most recent bytes written to it.
+// Storage is allocated on first use.
+class RingBuffer {
+ public:
+  explicit RingBuffer(size_t capacity) : capacity_(capacity) {}
+
+  // Returns how many older bytes were overwritten.
+  size_t Write(std::string_view data);
+  // Contents, oldest byte first.
+  std::string Contents() const;
+  size_t size() const { return size_; }
+
+ private:
+  size_t capacity_;
+  std::vector<char> data_;
+  size_t start_ = 0;
+  size_t size_ = 0;
+};
+
+// Splits a program's output into a head, passed to `sink` as it arrives, and
+// a tail kept in a RingBuffer. Bytes in between are only counted. The sink
+// is expected to spill to disk (see OutputBuffer), so memory use is bounded
+// by the tail size however much the program prints.
+class OutputCapture {
+ public:
+  using Sink = std::function<void(const std::string& chunk)>;
+
+  OutputCapture(const OutputLimits& limits, Sink sink);
+
+  void Write(std::string_view data);
+  // Passes a marker for the dropped bytes and the retained tail, from its
+  // first complete line on, to the sink. Call once, after the last Write().
+  void Finish();
+
+  std::uint64_t total_bytes() const { return total_; }
+  std::uint64_t captured_bytes() const { return total_ - dropped_bytes(); }
+  std::uint64_t dropped_bytes() const { return dropped_; }
+
+ private:
+  OutputLimits limits_;
+  Sink sink_;
+  RingBuffer tail_;
+  std::uint64_t total_ = 0;
+  std::uint64_t head_ = 0;
+  std::uint64_t dropped_ = 0;
+  bool head_ends_line_ = true;
+};
+
+#endif  // SRC_OUTPUT_CAPTURE_OUTPUT_CAPTURE_HPP_
@@ -0,0 +1,173 @@
+// Copyright 2024 Keys
+#include "perf_counters/perf_counters.hpp"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+struct EventSpec {
+  std::uint32_t type;
+  std::uint64_t config;
+  long long PerfCounts::*value;  // NOLINT [runtime/int]
+};
+
+constexpr std::uint64_t CacheEvent(std::uint64_t cache, std::uint64_t op,
+                                   std::uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+// The first entry is the group leader.
+const EventSpec kEvents[] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, &PerfCounts::cycles},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,
+     &PerfCounts::instructions},
+    {PERF_TYPE_HW_CACHE,
+     CacheEvent(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                PERF_COUNT_HW_CACHE_RESULT_MISS),
+     &PerfCounts::l1d_misses},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, &PerfCounts::llc_misses},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,
+     &PerfCounts::branch_misses},
+};
+
+int OpenEvent(const EventSpec& spec, int group_fd) {
+  struct perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  attr.read_format =
+      PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  attr.inherit = 1;
+  attr.exclude_kernel = 1;  // User-space only is allowed up to paranoid 2
+  attr.exclude_hv = 1;
+  if (group_fd == -1) {
+    attr.disabled = 1;
+    attr.enable_on_exec = 1;
+  }
+  return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1,
+                                  group_fd, PERF_FLAG_FD_CLOEXEC));
+}
+
+std::string ParanoidLevel() {
+  std::ifstream file("/proc/sys/kernel/perf_event_paranoid");
+  std::string level;
+  file >> level;
+  return level.empty() ? "?" : level;
+}
+
+std::string DescribeOpenError(int error) {
+  switch (error) {
+    case EACCES:
+    case EPERM:
+      return "blocked by perf_event_paranoid=" + ParanoidLevel();
+    case ENOENT:
+    case EOPNOTSUPP:
+      return "no hardware PMU available";
+    case ENOSYS:
+      return "kernel lacks perf_event_open";
+    default:
+      return std::strerror(error);
+  }
+}
+
+#endif  // __linux__
+
+std::string FormatCount(long long value) {  // NOLINT [runtime/int]
+  char buffer[32];
+  if (value < 10000) {
+    snprintf(buffer, sizeof(buffer), "%lld", value);
+  } else if (value < 10000000) {
+    snprintf(buffer, sizeof(buffer), "%.1fk", value / 1e3);
+  } else if (value < 10000000000LL) {
+    snprintf(buffer, sizeof(buffer), "%.1fM", value / 1e6);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%.1fG", value / 1e9);
+  }
+  return buffer;
+}
+
+}  // namespace
+
+PerfCounterGroup::PerfCounterGroup() {
+#ifdef __linux__
+  int leader = -1;
+  for (const EventSpec& spec : kEvents) {
+    int fd = OpenEvent(spec, leader);
+    if (fd < 0) {
+      if (leader == -1) {
+        unavailable_reason_ = DescribeOpenError(errno);
+        return;
+      }
+      continue;  // Member not supported by this PMU; leave it at -1
+    }
+    if (leader == -1) leader = fd;
+    counters_.push_back({fd, spec.value});
+  }
+#else
+  unavailable_reason_ = "perf_event_open is Linux-only";
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+  for (const Counter& counter : counters_) {
+    close(counter.fd);
+  }
+}
+
+PerfCounts PerfCounterGroup::Read() const {
+  PerfCounts counts;
+  counts.available = !counters_.empty();
+  counts.unavailable_reason = unavailable_reason_;
+  for (const Counter& counter : counters_) {
+    std::uint64_t data[3];  // value, time enabled, time running
+    if (read(counter.fd, data, sizeof(data)) != sizeof(data)) {
+      continue;
+    }
+    double value = static_cast<double>(data[0]);
+    // Scale up if the PMU had to multiplex the group
+    if (data[2] > 0 && data[2] < data[1]) {
+      value *= static_cast<double>(data[1]) / data[2];
+    }
+    counts.*counter.value = static_cast<long long>(value);  // NOLINT
+  }
+  return counts;
+}
+
+std::string FormatPerfCounts(const PerfCounts& counts) {
+  if (!counts.available) {
+    return "unavailable (" + counts.unavailable_reason + ")";
+  }
+
+  std::string line;
+  auto add = [&line](const char* label, long long value) {  // NOLINT
+    if (value < 0) return;
+    line += std::string(line.empty() ? "" : "  ") + label + " " +
+            FormatCount(value);
+  };
+  add("cycles", counts.cycles);
+  add("instr", counts.instructions);
+  if (counts.cycles > 0 && counts.instructions >= 0) {
+    char ipc[32];
+    snprintf(ipc, sizeof(ipc), "  IPC %.2f", counts.Ipc());
+    line += ipc;
+  }
+  add("L1d-miss", counts.l1d_misses);
+  add("LLC-miss", counts.llc_misses);
+  add("br-miss", counts.branch_misses);
+  return line;
+}
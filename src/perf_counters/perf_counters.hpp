@@ -0,0 +1,59 @@
+// Copyright 2024 Keys
+#ifndef SRC_PERF_COUNTERS_PERF_COUNTERS_HPP_
+#define SRC_PERF_COUNTERS_PERF_COUNTERS_HPP_
+
+#include <string>
+#include <vector>
+
+// Counter values for one child process; -1 marks an event that could not be
+// counted on this machine.
+struct PerfCounts {
+  bool available = false;  // The group leader (cycles) was counted
+  std::string unavailable_reason;
+
+  long long cycles = -1;            // NOLINT [runtime/int]
+  long long instructions = -1;      // NOLINT [runtime/int]
+  long long l1d_misses = -1;        // NOLINT [runtime/int]
+  long long llc_misses = -1;        // NOLINT [runtime/int]
+  long long branch_misses = -1;     // NOLINT [runtime/int]
+
+  double Ipc() const {
+    return cycles > 0 && instructions >= 0
+               ? static_cast<double>(instructions) / cycles
+               : 0;
+  }
+};
+
+// A perf_event_open counter group for the next child spawned by the calling
+// thread.
+//
+// The group is opened disabled on the calling thread with `inherit` and
+// `enable_on_exec`, so a child created afterwards (and every thread it
+// starts) inherits them and they only begin counting once the child execs
+// its program; the spawning thread itself is never measured. After the child
+// has been reaped its totals are folded back and Read() returns them. Open
+// the group immediately before spawning and destroy it right after, so
+// unrelated children are not counted.
+class PerfCounterGroup {
+ public:
+  PerfCounterGroup();
+  ~PerfCounterGroup();
+
+  PerfCounterGroup(const PerfCounterGroup&) = delete;
+  PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+  PerfCounts Read() const;
+
+ private:
+  struct Counter {
+    int fd;
+    long long PerfCounts::*value;  // NOLINT [runtime/int]
+  };
+  std::vector<Counter> counters_;
+  std::string unavailable_reason_;
+};
+
+// One line of counters for the output pane, or the reason they are missing.
+std::string FormatPerfCounts(const PerfCounts& counts);
+
+#endif  // SRC_PERF_COUNTERS_PERF_COUNTERS_HPP_
@@ -0,0 +1,143 @@
+// Copyright 2024 Keys
+#include "precompiled_header/precompiled_header.hpp"
+
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "compile_cache/compile_cache.hpp"
+#include "hash/hash.hpp"
+#include "process/process.hpp"
+#include "utils/utils.hpp"
+
+namespace {
+
+// Headers shared by nearly every solution in the tree.
+const char kPrefixHeader[] =
+    "#include <algorithm>\n"
+    "#include <climits>\n"
+    "#include <cmath>\n"
+    "#include <cstdio>\n"
+    "#include <deque>\n"
+    "#include <functional>\n"
+    "#include <iostream>\n"
+    "#include <map>\n"
+    "#include <numeric>\n"
+    "#include <queue>\n"
+    "#include <set>\n"
+    "#include <sstream>\n"
+    "#include <stack>\n"
+    "#include <string>\n"
+    "#include <unordered_map>\n"
+    "#include <unordered_set>\n"
+    "#include <utility>\n"
+    "#include <vector>\n";
+
+const char kHeaderName[] = "leetviewer_prefix.hpp";
+
+// The prefix for one compiler and flag set, built at most once per process
+struct PrefixBuild {
+  std::mutex mutex;  // Held while building
+  bool done = false;
+  std::vector<std::string> args;
+};
+
+bool IsClang(const std::string& compiler) {
+  return CompilerVersion(compiler).find("clang version") != std::string::npos;
+}
+
+// Builds the header and its PCH in `dir`; returns the header path or "".
+std::string BuildPrecompiledHeader(const std::string& dir,
+                                   const std::string& compiler,
+                                   const std::vector<std::string>& flags) {
+  std::string header = dir + "/" + kHeaderName;
+  // GCC and Clang both pick up "<header>.gch" / "<header>.pch" automatically
+  // when the header is passed through -include.
+  std::string pch = header + (IsClang(compiler) ? ".pch" : ".gch");
+  if (access(pch.c_str(), R_OK) == 0) {
+    return header;
+  }
+
+  if (!MakeDirectories(dir)) {
+    return "";
+  }
+  {
+    std::ofstream out(header, std::ios::trunc);
+    out << kPrefixHeader;
+    if (!out) {
+      return "";
+    }
+  }
+
+  std::string staging = pch + ".tmp." + std::to_string(getpid());
+  std::vector<std::string> argv = {compiler};
+  argv.insert(argv.end(), flags.begin(), flags.end());
+  argv.insert(argv.end(), {"-x", "c++-header", header, "-o", staging});
+  if (!RunProcess(argv).Succeeded() ||
+      rename(staging.c_str(), pch.c_str()) != 0) {
+    unlink(staging.c_str());
+    return "";
+  }
+  return header;
+}
+
+}  // namespace
+
+std::vector<std::string> PrecompiledHeaderArgs(
+    const std::string& compiler, const std::vector<std::string>& flags) {
+  if (GetEnvLong("LEETVIEWER_NO_PCH", 0) != 0) {
+    return {};
+  }
+
+  // Each compiler and flag set has its own lock, so first builds for
+  // different profiles (e.g. the profile matrix) run side by side
+  static std::mutex mutex;
+  static std::map<std::pair<std::string, std::vector<std::string>>,
+                  std::unique_ptr<PrefixBuild>>
+      builds;
+  PrefixBuild* build;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<PrefixBuild>& slot = builds[{compiler, flags}];
+    if (!slot) slot = std::make_unique<PrefixBuild>();
+    build = slot.get();
+  }
+
+  std::lock_guard<std::mutex> lock(build->mutex);
+  if (build->done) {
+    return build->args;
+  }
+
+  std::string version = CompilerVersion(compiler);
+  Hasher hasher;
+  hasher.Update(compiler.size()).Update(compiler);
+  hasher.Update(version.size()).Update(version);
+  hasher.Update(flags.size());
+  for (const std::string& flag : flags) {
+    hasher.Update(flag.size()).Update(flag);
+  }
+  hasher.Update(kPrefixHeader);
+  std::string dir = GetCacheRoot() + "/pch/" + ToHex(hasher.Digest());
+
+  std::string header = BuildPrecompiledHeader(dir, compiler, flags);
+  if (!header.empty()) {
+    build->args = {"-include", header};
+  }
+  build->done = true;
+  return build->args;
+}
+
+std::vector<std::string> FlagsWithPrecompiledHeader(
+    const std::string& compiler, const std::vector<std::string>& flags) {
+  std::vector<std::string> all = flags;
+  std::vector<std::string> pch_args = PrecompiledHeaderArgs(compiler, flags);
+  all.insert(all.end(), pch_args.begin(), pch_args.end());
+  return all;
+}
@@ -0,0 +1,28 @@
+// Copyright 2024 Keys
+#ifndef SRC_PRECOMPILED_HEADER_PRECOMPILED_HEADER_HPP_
+#define SRC_PRECOMPILED_HEADER_PRECOMPILED_HEADER_HPP_
+
+#include <string>
+#include <vector>
+
+// Returns the compiler arguments that force-include LeetViewer's shared
+// standard-header prefix, building its precompiled form on first use.
+// Every solution therefore sees those 18 standard headers, so one that
+// forgets its own #includes still compiles here but not on its own.
+//
+// The PCH is stored under <cache root>/pch in a directory keyed by the
+// compiler, its version, `flags` and the prefix itself, so a different
+// toolchain or flag set transparently gets its own build. Returns an empty
+// list when the PCH cannot be built or LEETVIEWER_NO_PCH is set, in which
+// case solutions simply compile without it.
+std::vector<std::string> PrecompiledHeaderArgs(
+    const std::string& compiler, const std::vector<std::string>& flags);
+
+// `flags` followed by PrecompiledHeaderArgs(): everything a solution is
+// compiled with besides its own path. The compile cache and the run
+// history key on this, so turning the prefix off or changing it gives
+// different entries.
+std::vector<std::string> FlagsWithPrecompiledHeader(
+    const std::string& compiler, const std::vector<std::string>& flags);
+
+#endif  // SRC_PRECOMPILED_HEADER_PRECOMPILED_HEADER_HPP_
@@ -0,0 +1,73 @@
+// Copyright 2024 Keys
+#include "prefetch/prefetch.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT [build/c++11]
+#include <deque>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <thread>  // NOLINT [build/c++11]
+#include <vector>
+
+#include "build_profile/build_profile.hpp"
+#include "runner/runner.hpp"
+
+struct CompilePrefetcher::State {
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::deque<std::string> queue;
+  std::string current;  // File being compiled, empty when idle
+  std::atomic<bool> cancel_current{false};
+  bool stopped = false;
+};
+
+CompilePrefetcher::CompilePrefetcher() : state_(std::make_shared<State>()) {
+  std::shared_ptr<State> state = state_;
+  // Detached so that leaving the menu never waits on the compiler
+  std::thread([state]() {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    while (true) {
+      state->wake.wait(
+          lock, [&]() { return state->stopped || !state->queue.empty(); });
+      if (state->queue.empty()) return;  // Stopped with nothing left
+
+      state->current = state->queue.front();
+      state->queue.pop_front();
+      state->cancel_current = false;
+      std::string path = state->current;
+      lock.unlock();
+
+      // The profile may have been switched in the code view since the
+      // last job
+      std::string binary_path, diagnostics;
+      CompileCppFile(path, ActiveBuildProfile(), &binary_path, &diagnostics,
+                     &state->cancel_current);
+
+      lock.lock();
+      state->current.clear();
+    }
+  }).detach();
+}
+
+CompilePrefetcher::~CompilePrefetcher() {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->queue.clear();
+  state_->stopped = true;
+  state_->wake.notify_one();
+}
+
+void CompilePrefetcher::Prefetch(
+    const std::vector<std::string>& cpp_file_paths) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->queue.clear();
+  for (const std::string& path : cpp_file_paths) {
+    if (path != state_->current) state_->queue.push_back(path);
+  }
+  if (!state_->current.empty() &&
+      std::find(cpp_file_paths.begin(), cpp_file_paths.end(),
+                state_->current) == cpp_file_paths.end()) {
+    state_->cancel_current = true;
+  }
+  state_->wake.notify_one();
+}
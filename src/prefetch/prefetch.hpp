@@ -0,0 +1,33 @@
+// Copyright 2024 Keys
+#ifndef SRC_PREFETCH_PREFETCH_HPP_
+#define SRC_PREFETCH_PREFETCH_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Speculatively compiles solutions into the compile cache while the user is
+// still choosing one, so the run starts without waiting for the compiler.
+//
+// A single background worker builds the wanted files in priority order,
+// each with the build profile that is active when its compile starts.
+class CompilePrefetcher {
+ public:
+  CompilePrefetcher();
+  // Drops queued files. A compile already running is left to finish, since
+  // it is usually the file that was just picked.
+  ~CompilePrefetcher();
+
+  CompilePrefetcher(const CompilePrefetcher&) = delete;
+  CompilePrefetcher& operator=(const CompilePrefetcher&) = delete;
+
+  // Replaces the wanted set with `cpp_file_paths`, most important first.
+  // A compile in progress for a file that is no longer wanted is killed.
+  void Prefetch(const std::vector<std::string>& cpp_file_paths);
+
+ private:
+  struct State;
+  std::shared_ptr<State> state_;
+};
+
+#endif  // SRC_PREFETCH_PREFETCH_HPP_
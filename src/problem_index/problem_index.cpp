@@ -0,0 +1,669 @@
+// Copyright 2024 Keys
+#include "problem_index/problem_index.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT [build/c++11]
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <thread>  // NOLINT [build/c++11]
+#include <utility>
+#include <vector>
+
+#include "compile_cache/compile_cache.hpp"
+#include "dir_scanner/dir_scanner.hpp"
+#include "file_handler/file_handler.hpp"
+#include "hash/hash.hpp"
+#include "utils/utils.hpp"
+
+namespace {
+
+// On-disk layout: IndexHeader, problem_count ProblemRecords, file_count
+// FileRecords (grouped by problem), then strings_size bytes of names.
+constexpr char kMagic[8] = {'L', 'V', 'I', 'D', 'X', 'v', '0', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+struct IndexHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t problem_count;
+  std::uint32_t file_count;
+  std::uint32_t strings_size;
+  std::uint64_t root_hash;
+};
+
+struct ProblemRecord {
+  std::uint32_t name_offset;
+  std::uint32_t name_length;
+  std::int64_t mtime_ns;
+  std::uint32_t first_file;
+  std::uint32_t file_count;
+  std::uint32_t scanned;
+  std::uint32_t reserved;
+};
+
+struct FileRecord {
+  std::uint32_t name_offset;
+  std::uint32_t name_length;
+  std::uint64_t size;
+  std::int64_t mtime_ns;
+  std::uint64_t content_hash;
+  std::int64_t run_finished_at;
+  std::int64_t run_wall_ns;
+  std::int32_t run_exit_code;
+  std::int32_t run_term_signal;
+};
+
+// Changes are batched for this long before the index is rewritten
+constexpr auto kSaveDelay = std::chrono::seconds(2);
+
+struct Problem {
+  std::int64_t mtime_ns = 0;
+  bool scanned = false;
+  std::map<std::string, SolutionFile> files;
+};
+
+std::int64_t MtimeNs(const struct stat& info) {
+#ifdef __APPLE__
+  return info.st_mtimespec.tv_sec * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+  return info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+}
+
+std::uint64_t HashFile(const std::string& path) {
+  std::ifstream stream(path, std::ios::binary);
+  std::string content((std::istreambuf_iterator<char>(stream)),
+                      std::istreambuf_iterator<char>());
+  std::uint64_t hash = HashBytes(content);
+  return hash == 0 ? 1 : hash;  // 0 means "not hashed"
+}
+
+// Stats the solutions `file_names` of one problem. Entries of `previous`
+// whose size and mtime still match are reused as they are; the rest are
+// rehashed, keeping their last run if the content turns out unchanged.
+Problem ScanProblemDir(const std::string& root, const std::string& name,
+                       const std::vector<std::string>& file_names,
+                       const Problem& previous) {
+  std::string dir = root + "/" + name;
+  Problem problem;
+  struct stat info;
+  if (stat(dir.c_str(), &info) == 0) problem.mtime_ns = MtimeNs(info);
+  problem.scanned = true;
+  for (const std::string& file_name : file_names) {
+    std::string path = dir + "/" + file_name;
+    if (stat(path.c_str(), &info) != 0) continue;
+    SolutionFile file;
+    file.name = file_name;
+    file.size = info.st_size;
+    file.mtime_ns = MtimeNs(info);
+    auto old = previous.files.find(file_name);
+    if (old != previous.files.end() && old->second.size == file.size &&
+        old->second.mtime_ns == file.mtime_ns &&
+        old->second.content_hash != 0) {
+      file = old->second;
+    } else {
+      file.content_hash = HashFile(path);
+      if (old != previous.files.end() &&
+          old->second.content_hash == file.content_hash) {
+        file.last_run = old->second.last_run;
+      }
+    }
+    problem.files[file_name] = std::move(file);
+  }
+  return problem;
+}
+
+bool SameListing(const Problem& a, const Problem& b) {
+  if (a.mtime_ns != b.mtime_ns || a.scanned != b.scanned ||
+      a.files.size() != b.files.size()) {
+    return false;
+  }
+  for (auto ai = a.files.begin(), bi = b.files.begin(); ai != a.files.end();
+       ++ai, ++bi) {
+    if (ai->first != bi->first || ai->second.size != bi->second.size ||
+        ai->second.mtime_ns != bi->second.mtime_ns ||
+        ai->second.content_hash != bi->second.content_hash) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// "<root>/two_sum/hash_map.cpp" -> "two_sum", "hash_map.cpp"; problems
+// may be nested, as in "<root>/arrays/two_sum/hash_map.cpp"
+bool SplitSolutionPath(const std::string& root, const std::string& path,
+                       std::string* problem, std::string* file) {
+  std::string prefix = root + "/";
+  if (path.compare(0, prefix.size(), prefix) != 0) return false;
+  size_t slash = path.rfind('/');
+  if (slash < prefix.size()) return false;
+  *problem = path.substr(prefix.size(), slash - prefix.size());
+  *file = path.substr(slash + 1);
+  return true;
+}
+
+}  // namespace
+
+struct ProblemIndex::State {
+  std::string root;
+  std::string index_path;
+
+  std::mutex mutex;
+  std::map<std::string, Problem> problems;
+  bool dirty = false;
+  std::chrono::steady_clock::time_point dirty_since;
+  std::atomic<std::uint64_t> version{0};  // Bumped on listing changes
+
+  int inotify_fd = -1;
+  int wake_pipe[2] = {-1, -1};  // Written to stop the watcher
+  // Every directory of the tree is watched; "" is the root
+  std::map<int, std::string> watches;  // Descriptor -> directory
+  std::map<std::string, int> watched;  // Directory -> descriptor
+  std::atomic<bool> stopped{false};
+  std::thread watcher;
+
+  void MarkDirty() {
+    if (!dirty) dirty_since = std::chrono::steady_clock::now();
+    dirty = true;
+  }
+
+  // A problem or solution was added, removed or changed
+  void MarkChanged() {
+    ++version;
+    MarkDirty();
+  }
+
+  // Stores a fresh scan of directory `name`, keeping runs recorded while
+  // it was going on. A directory without solutions is not a problem.
+  void Merge(const std::string& name, Problem scanned) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = problems.find(name);
+    if (scanned.files.empty()) {
+      if (it != problems.end()) {
+        problems.erase(it);
+        MarkChanged();
+      }
+      return;
+    }
+    Problem& current = problems[name];
+    for (auto& [file_name, file] : scanned.files) {
+      auto old = current.files.find(file_name);
+      if (old != current.files.end() &&
+          old->second.content_hash == file.content_hash) {
+        file.last_run = old->second.last_run;
+      }
+    }
+    if (!SameListing(current, scanned)) MarkChanged();
+    current = std::move(scanned);
+  }
+
+  // The entry for `name` as it is now, or an empty one
+  Problem Current(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = problems.find(name);
+    return it != problems.end() ? it->second : Problem();
+  }
+
+  // Re-lists one directory, hashing without holding the lock
+  void Rescan(const std::string& name) {
+    std::string dir = root + "/" + name;
+    std::vector<std::string> file_names;
+    struct stat info;
+    if (stat(dir.c_str(), &info) == 0 && S_ISDIR(info.st_mode)) {
+      file_names = ListFiles(dir, ".cpp");
+    }
+    Merge(name, ScanProblemDir(root, name, file_names, Current(name)));
+  }
+
+  // Drops `name` and everything below it, after it was deleted or moved
+  void RemoveTree(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Sorted, everything starting with `name` follows it; "a-b" comes
+    // between "a" and "a/b", so the loops skip such siblings
+    auto starts_with_name = [&](const std::string& path) {
+      return path.compare(0, name.size(), name) == 0;
+    };
+    auto inside = [&](const std::string& path) {
+      return path.size() == name.size() || path[name.size()] == '/';
+    };
+    for (auto it = problems.lower_bound(name);
+         it != problems.end() && starts_with_name(it->first);) {
+      if (inside(it->first)) {
+        it = problems.erase(it);
+        MarkChanged();
+      } else {
+        ++it;
+      }
+    }
+    // The directories may live on elsewhere after a move out of the
+    // tree, so their watches are dropped rather than left to report
+    // events under the old names
+    for (auto it = watched.lower_bound(name);
+         it != watched.end() && starts_with_name(it->first);) {
+      if (!inside(it->first)) {
+        ++it;
+        continue;
+      }
+#ifdef __linux__
+      if (inotify_fd >= 0) inotify_rm_watch(inotify_fd, it->second);
+#endif
+      watches.erase(it->second);
+      it = watched.erase(it);
+    }
+  }
+
+  // The solution entry for `path`, or nullptr. Expects `mutex` to be held.
+  SolutionFile* Find(const std::string& path) {
+    std::string problem, file;
+    if (!SplitSolutionPath(root, path, &problem, &file)) return nullptr;
+    auto dir = problems.find(problem);
+    if (dir == problems.end()) return nullptr;
+    auto entry = dir->second.files.find(file);
+    return entry == dir->second.files.end() ? nullptr : &entry->second;
+  }
+
+  // Time left until pending changes should be written; -1 if there are none
+  int SaveDelayMs() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!dirty) return -1;
+    auto due = dirty_since + kSaveDelay - std::chrono::steady_clock::now();
+    return std::max<int>(
+        0,
+        std::chrono::duration_cast<std::chrono::milliseconds>(due).count());
+  }
+
+  bool Load();
+  void Save();
+  void AddWatch(const std::string& name);
+  void ScanBelow(const std::string& base, std::set<std::string>* seen);
+  void Revalidate();
+  void HandleEvents();
+  void Run();
+};
+
+bool ProblemIndex::State::Load() {
+  int fd = open(index_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+  struct stat info;
+  if (fstat(fd, &info) != 0 ||
+      static_cast<size_t>(info.st_size) < sizeof(IndexHeader)) {
+    close(fd);
+    return false;
+  }
+  size_t size = info.st_size;
+  void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping == MAP_FAILED) return false;
+
+  const char* data = static_cast<const char*>(mapping);
+  IndexHeader header;
+  std::memcpy(&header, data, sizeof(header));
+  size_t problems_offset = sizeof(IndexHeader);
+  size_t files_offset =
+      problems_offset + header.problem_count * sizeof(ProblemRecord);
+  size_t strings_offset = files_offset + header.file_count * sizeof(FileRecord);
+  bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+               header.version == kVersion &&
+               header.root_hash == HashBytes(root) &&
+               strings_offset + header.strings_size == size;
+
+  auto name_at = [&](std::uint32_t offset, std::uint32_t length,
+                     std::string* name) {
+    if (static_cast<std::uint64_t>(offset) + length > header.strings_size) {
+      return false;
+    }
+    name->assign(data + strings_offset + offset, length);
+    return true;
+  };
+  std::map<std::string, Problem> loaded;
+  for (std::uint32_t i = 0; valid && i < header.problem_count; ++i) {
+    ProblemRecord record;
+    std::memcpy(&record, data + problems_offset + i * sizeof(record),
+                sizeof(record));
+    std::string name;
+    if (!name_at(record.name_offset, record.name_length, &name) ||
+        static_cast<std::uint64_t>(record.first_file) + record.file_count >
+            header.file_count) {
+      valid = false;
+      break;
+    }
+    Problem& problem = loaded[name];
+    problem.mtime_ns = record.mtime_ns;
+    problem.scanned = record.scanned != 0;
+    for (std::uint32_t j = 0; j < record.file_count; ++j) {
+      FileRecord file_record;
+      std::memcpy(&file_record,
+                  data + files_offset +
+                      (record.first_file + j) * sizeof(file_record),
+                  sizeof(file_record));
+      SolutionFile file;
+      if (!name_at(file_record.name_offset, file_record.name_length,
+                   &file.name)) {
+        valid = false;
+        break;
+      }
+      file.size = file_record.size;
+      file.mtime_ns = file_record.mtime_ns;
+      file.content_hash = file_record.content_hash;
+      file.last_run.finished_at = file_record.run_finished_at;
+      file.last_run.wall_ns = file_record.run_wall_ns;
+      file.last_run.exit_code = file_record.run_exit_code;
+      file.last_run.term_signal = file_record.run_term_signal;
+      problem.files[file.name] = std::move(file);
+    }
+  }
+  munmap(mapping, size);
+  if (!valid) return false;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  problems = std::move(loaded);
+  return true;
+}
+
+void ProblemIndex::State::Save() {
+  std::string strings;
+  std::vector<ProblemRecord> problem_records;
+  std::vector<FileRecord> file_records;
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!dirty) return;
+    dirty = false;
+    for (const auto& [name, problem] : problems) {
+      ProblemRecord record = {};
+      record.name_offset = static_cast<std::uint32_t>(strings.size());
+      record.name_length = static_cast<std::uint32_t>(name.size());
+      strings += name;
+      record.mtime_ns = problem.mtime_ns;
+      record.first_file = static_cast<std::uint32_t>(file_records.size());
+      record.file_count = static_cast<std::uint32_t>(problem.files.size());
+      record.scanned = problem.scanned;
+      problem_records.push_back(record);
+      for (const auto& [file_name, file] : problem.files) {
+        FileRecord file_record = {};
+        file_record.name_offset = static_cast<std::uint32_t>(strings.size());
+        file_record.name_length = static_cast<std::uint32_t>(file_name.size());
+        strings += file_name;
+        file_record.size = file.size;
+        file_record.mtime_ns = file.mtime_ns;
+        file_record.content_hash = file.content_hash;
+        file_record.run_finished_at = file.last_run.finished_at;
+        file_record.run_wall_ns = file.last_run.wall_ns;
+        file_record.run_exit_code = file.last_run.exit_code;
+        file_record.run_term_signal = file.last_run.term_signal;
+        file_records.push_back(file_record);
+      }
+    }
+  }
+
+  IndexHeader header = {};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.problem_count = static_cast<std::uint32_t>(problem_records.size());
+  header.file_count = static_cast<std::uint32_t>(file_records.size());
+  header.strings_size = static_cast<std::uint32_t>(strings.size());
+  header.root_hash = HashBytes(root);
+
+  // Written beside the index and renamed over it, so readers never see a
+  // partial file
+  std::string dir = index_path.substr(0, index_path.find_last_of('/'));
+  MakeDirectories(dir);
+  std::string staging = index_path + ".tmp" + std::to_string(getpid());
+  FILE* out = std::fopen(staging.c_str(), "wb");
+  if (out == nullptr) return;
+  bool ok = std::fwrite(&header, sizeof(header), 1, out) == 1;
+  ok = ok && std::fwrite(problem_records.data(), sizeof(ProblemRecord),
+                         problem_records.size(),
+                         out) == problem_records.size();
+  ok = ok && std::fwrite(file_records.data(), sizeof(FileRecord),
+                         file_records.size(), out) == file_records.size();
+  ok = ok && std::fwrite(strings.data(), 1, strings.size(), out) ==
+                 strings.size();
+  ok = std::fclose(out) == 0 && ok;
+  if (!ok || std::rename(staging.c_str(), index_path.c_str()) != 0) {
+    std::remove(staging.c_str());
+  }
+}
+
+void ProblemIndex::State::AddWatch(const std::string& name) {
+#ifdef __linux__
+  if (inotify_fd < 0) return;
+  int wd = inotify_add_watch(
+      inotify_fd, (name.empty() ? root : root + "/" + name).c_str(),
+      IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_CLOSE_WRITE |
+          IN_ONLYDIR);
+  if (wd < 0) return;  // e.g. out of watches: fall back to stat checks
+  std::lock_guard<std::mutex> lock(mutex);
+  // A directory moved within the tree lost its watch in RemoveTree and is
+  // watched again here under the new name. inotify hands back the existing
+  // descriptor when the inode is still watched, e.g. when the move-in is
+  // seen before the move-out, so the stale name is dropped.
+  auto old = watches.find(wd);
+  if (old != watches.end() && old->second != name) watched.erase(old->second);
+  watches[wd] = name;
+  watched[name] = wd;
+#endif
+}
+
+// Scans the tree below directory `base` in parallel, hashing on the
+// scanner's threads, and records the problems found in `seen`
+void ProblemIndex::State::ScanBelow(const std::string& base,
+                                    std::set<std::string>* seen) {
+  std::mutex seen_mutex;
+  ScanTree(
+      base.empty() ? root : root + "/" + base, ".cpp",
+      [&](const ScannedDir& dir) {
+        std::string name = base.empty() || dir.path.empty()
+                               ? base + dir.path
+                               : base + "/" + dir.path;
+        // Watched as soon as it has been read; a change in between is
+        // picked up by the next revalidation
+        AddWatch(name);
+        if (name.empty()) return;  // Files right in the root are no problem
+        if (!dir.files.empty()) {
+          std::lock_guard<std::mutex> lock(seen_mutex);
+          seen->insert(name);
+        }
+        Merge(name, ScanProblemDir(root, name, dir.files, Current(name)));
+      },
+      &stopped);
+}
+
+void ProblemIndex::State::Revalidate() {
+  std::set<std::string> seen;
+  ScanBelow("", &seen);
+  if (stopped) return;  // The scan was cut short
+  // Problems whose directory is gone or no longer holds solutions
+  std::lock_guard<std::mutex> lock(mutex);
+  for (auto it = problems.begin(); it != problems.end();) {
+    if (seen.count(it->first) == 0) {
+      it = problems.erase(it);
+      MarkChanged();
+    } else {
+      ++it;
+    }
+  }
+}
+
+void ProblemIndex::State::HandleEvents() {
+#ifdef __linux__
+  alignas(struct inotify_event) char buffer[16384];
+  ssize_t length = read(inotify_fd, buffer, sizeof(buffer));
+  std::vector<std::string> changed;  // Directories whose files changed
+  std::vector<std::string> added;    // Directories that appeared
+  bool relist = false;
+  for (ssize_t offset = 0; offset < length;) {
+    const struct inotify_event* event =
+        reinterpret_cast<const struct inotify_event*>(buffer + offset);
+    offset += sizeof(struct inotify_event) + event->len;
+    if (event->mask & IN_Q_OVERFLOW) {
+      relist = true;
+      continue;
+    }
+    std::string dir;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = watches.find(event->wd);
+      if (it == watches.end()) continue;
+      dir = it->second;
+      if (event->mask & IN_IGNORED) {
+        auto entry = watched.find(dir);
+        if (entry != watched.end() && entry->second == event->wd) {
+          watched.erase(entry);
+        }
+        watches.erase(it);
+        continue;
+      }
+    }
+    std::string name = event->len > 0 ? event->name : "";
+    if (!(event->mask & IN_ISDIR)) {
+      if (!dir.empty()) changed.push_back(dir);
+      continue;
+    }
+    // A subdirectory appeared or went away
+    if (name.empty() || name[0] == '.') continue;
+    std::string child = dir.empty() ? name : dir + "/" + name;
+    if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+      added.push_back(child);
+    } else {
+      RemoveTree(child);
+    }
+  }
+  if (relist) {
+    Revalidate();
+    return;
+  }
+  std::set<std::string> seen;
+  for (const std::string& dir : added) ScanBelow(dir, &seen);
+  std::sort(changed.begin(), changed.end());
+  changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+  for (const std::string& dir : changed) Rescan(dir);
+#endif
+}
+
+void ProblemIndex::State::Run() {
+#ifdef __linux__
+  inotify_fd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+#endif
+  Revalidate();
+  Save();
+
+  while (!stopped) {
+    struct pollfd fds[2] = {{wake_pipe[0], POLLIN, 0},
+                            {inotify_fd, POLLIN, 0}};
+    int ready = poll(fds, inotify_fd >= 0 ? 2 : 1, SaveDelayMs());
+    if (stopped) break;
+    if (ready > 0 && (fds[1].revents & POLLIN)) HandleEvents();
+    if (SaveDelayMs() == 0) Save();
+  }
+#ifdef __linux__
+  if (inotify_fd >= 0) close(inotify_fd);
+#endif
+}
+
+ProblemIndex::ProblemIndex(const std::string& root)
+    : state_(std::make_unique<State>()) {
+  State* state = state_.get();
+  state->root = root;
+  state->index_path =
+      GetCacheRoot() + "/index/" + ToHex(HashBytes(root)) + ".idx";
+  // Without an index the menu starts empty and problems stream in from
+  // the first scan
+  state->Load();
+  if (pipe(state->wake_pipe) == 0) {
+    state->watcher = std::thread([state]() { state->Run(); });
+  }
+}
+
+ProblemIndex::~ProblemIndex() {
+  state_->stopped = true;
+  if (state_->watcher.joinable()) {
+    ssize_t written = write(state_->wake_pipe[1], "x", 1);
+    (void)written;
+    state_->watcher.join();
+  }
+  for (int fd : state_->wake_pipe) {
+    if (fd >= 0) close(fd);
+  }
+  state_->Save();
+}
+
+std::vector<std::string> ProblemIndex::Problems() {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  std::vector<std::string> names;
+  names.reserve(state_->problems.size());
+  for (const auto& entry : state_->problems) names.push_back(entry.first);
+  return names;
+}
+
+std::vector<std::string> ProblemIndex::Files(const std::string& problem) {
+  bool current;
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    auto it = state_->problems.find(problem);
+    current = it != state_->problems.end() && it->second.scanned &&
+              state_->watched.count(problem) > 0;
+  }
+  // Not listed yet, or not watched and possibly stale
+  if (!current) state_->Rescan(problem);
+
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  std::vector<std::string> names;
+  auto it = state_->problems.find(problem);
+  if (it == state_->problems.end()) return names;
+  for (const auto& entry : it->second.files) names.push_back(entry.first);
+  return names;
+}
+
+std::vector<std::pair<std::string, std::uint64_t>> ProblemIndex::Solutions() {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  std::vector<std::pair<std::string, std::uint64_t>> solutions;
+  for (const auto& [name, problem] : state_->problems) {
+    for (const auto& [file_name, file] : problem.files) {
+      solutions.emplace_back(name + "/" + file_name, file.content_hash);
+    }
+  }
+  return solutions;
+}
+
+std::uint64_t ProblemIndex::version() const { return state_->version; }
+
+bool ProblemIndex::Lookup(const std::string& file_path, SolutionFile* file) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  const SolutionFile* entry = state_->Find(file_path);
+  if (entry == nullptr) return false;
+  *file = *entry;
+  return true;
+}
+
+void ProblemIndex::RecordRun(const std::string& file_path,
+                             const ProcessResult& result) {
+  if (!result.started) return;
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  SolutionFile* entry = state_->Find(file_path);
+  if (entry == nullptr) return;
+  RunRecord& run = entry->last_run;
+  run.finished_at = std::time(nullptr);
+  run.wall_ns = result.wall_ns;
+  run.exit_code = result.exit_code;
+  run.term_signal = result.term_signal;
+  state_->MarkDirty();
+}
+
+void ProblemIndex::Save() { state_->Save(); }
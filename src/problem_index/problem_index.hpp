@@ -0,0 +1,72 @@
+// Copyright 2024 Keys
+#ifndef SRC_PROBLEM_INDEX_PROBLEM_INDEX_HPP_
+#define SRC_PROBLEM_INDEX_PROBLEM_INDEX_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "process/process.hpp"
+
+// Outcome of the most recent run of a solution.
+struct RunRecord {
+  std::int64_t finished_at = 0;  // Unix seconds; 0 if never run
+  std::int64_t wall_ns = 0;
+  std::int32_t exit_code = -1;
+  std::int32_t term_signal = 0;
+};
+
+struct SolutionFile {
+  std::string name;
+  std::uint64_t size = 0;
+  std::int64_t mtime_ns = 0;
+  std::uint64_t content_hash = 0;  // 0 until hashed
+  RunRecord last_run;              // Cleared when the content changes
+};
+
+// The problem directories under a root and the .cpp solutions in each,
+// persisted across launches. A problem is any directory below the root,
+// at any depth, that holds solutions; it is named by its path relative to
+// the root, e.g. "two_sum" or "arrays/two_sum".
+//
+// The index is stored under <cache root>/index as one file of fixed-size
+// records followed by a string table, read straight from a read-only
+// mapping. With an index on disk the menus are served from it at once.
+// A background thread then walks the tree with ScanTree(), rehashing only
+// files whose size or mtime changed, and follows later changes through
+// inotify. Without an index, problems appear as that first walk finds
+// them. Changes are written back a few seconds after they happen and on
+// destruction.
+class ProblemIndex {
+ public:
+  explicit ProblemIndex(const std::string& root);
+  ~ProblemIndex();
+
+  ProblemIndex(const ProblemIndex&) = delete;
+  ProblemIndex& operator=(const ProblemIndex&) = delete;
+
+  // Problem directory paths, sorted.
+  std::vector<std::string> Problems();
+  // Solution file names in `problem`, sorted.
+  std::vector<std::string> Files(const std::string& problem);
+  // Every solution scanned so far as "<problem>/<file>", with its content
+  // hash.
+  std::vector<std::pair<std::string, std::uint64_t>> Solutions();
+  // Changes whenever a problem or solution is added, removed or modified.
+  std::uint64_t version() const;
+  // Entry for `file_path`, a solution path below the root.
+  bool Lookup(const std::string& file_path, SolutionFile* file);
+  // Stores the outcome of running `file_path`.
+  void RecordRun(const std::string& file_path, const ProcessResult& result);
+
+  // Writes the index to disk if it changed.
+  void Save();
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+#endif  // SRC_PROBLEM_INDEX_PROBLEM_INDEX_HPP_
@@ -0,0 +1,198 @@
+// Copyright 2024 Keys
+#include "process/process.hpp"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>  // NOLINT [build/c++11]
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+extern char** environ;
+
+namespace {
+
+long long TimevalToNs(const struct timeval& tv) {  // NOLINT [runtime/int]
+  return tv.tv_sec * 1000000000LL + tv.tv_usec * 1000LL;
+}
+
+void ClosePipe(int fds[2]) {
+  for (int i = 0; i < 2; ++i) {
+    if (fds[i] >= 0) close(fds[i]);
+    fds[i] = -1;
+  }
+}
+
+}  // namespace
+
+ProcessResult RunProcess(const std::vector<std::string>& argv,
+                         const ProcessOptions& options) {
+  ProcessResult result;
+  if (argv.empty()) {
+    result.error = "empty command";
+    return result;
+  }
+
+  int out_pipe[2] = {-1, -1};
+  int err_pipe[2] = {-1, -1};
+  int report_pipe[2] = {-1, -1};
+  if (pipe2(out_pipe, O_CLOEXEC) != 0 || pipe2(err_pipe, O_CLOEXEC) != 0 ||
+      (options.capture_report_fd && pipe2(report_pipe, O_CLOEXEC) != 0)) {
+    result.error = std::strerror(errno);
+    ClosePipe(out_pipe);
+    ClosePipe(err_pipe);
+    ClosePipe(report_pipe);
+    return result;
+  }
+
+  posix_spawn_file_actions_t actions;
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDIN_FILENO,
+                                   options.stdin_path.c_str(), O_RDONLY, 0);
+  posix_spawn_file_actions_adddup2(&actions, out_pipe[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, err_pipe[1], STDERR_FILENO);
+  if (options.capture_report_fd) {
+    posix_spawn_file_actions_adddup2(&actions, report_pipe[1], 3);
+  }
+
+  std::vector<char*> args;
+  for (const std::string& arg : argv) {
+    args.push_back(const_cast<char*>(arg.c_str()));
+  }
+  args.push_back(nullptr);
+
+  // Entries in extra_env replace inherited variables of the same name
+  std::vector<char*> env;
+  for (char** entry = environ; *entry != nullptr; ++entry) {
+    bool overridden = false;
+    for (const std::string& extra : options.extra_env) {
+      size_t name_length = extra.find('=') + 1;
+      if (std::strncmp(*entry, extra.c_str(), name_length) == 0) {
+        overridden = true;
+        break;
+      }
+    }
+    if (!overridden) env.push_back(*entry);
+  }
+  for (const std::string& entry : options.extra_env) {
+    env.push_back(const_cast<char*>(entry.c_str()));
+  }
+  env.push_back(nullptr);
+
+  // Opened right before the spawn so only this child inherits the counters
+  std::unique_ptr<PerfCounterGroup> counters;
+  if (options.collect_counters) {
+    counters = std::make_unique<PerfCounterGroup>();
+  }
+
+  pid_t pid;
+  auto start_time = std::chrono::steady_clock::now();
+  int spawn_error = posix_spawnp(&pid, args[0], &actions, nullptr, args.data(),
+                                 env.data());
+  posix_spawn_file_actions_destroy(&actions);
+  close(out_pipe[1]);
+  close(err_pipe[1]);
+  if (report_pipe[1] >= 0) close(report_pipe[1]);
+  if (spawn_error != 0) {
+    result.error = argv[0] + ": " + std::strerror(spawn_error);
+    close(out_pipe[0]);
+    close(err_pipe[0]);
+    if (report_pipe[0] >= 0) close(report_pipe[0]);
+    return result;
+  }
+  result.started = true;
+
+  const OutputCallback no_callback;
+  struct pollfd fds[3] = {{out_pipe[0], POLLIN, 0},
+                          {err_pipe[0], POLLIN, 0},
+                          {report_pipe[0], POLLIN, 0}};
+  std::string* sinks[3] = {&result.stdout_data, &result.stderr_data,
+                           &result.report_data};
+  const OutputCallback* callbacks[3] = {&options.on_stdout, &options.on_stderr,
+                                        &no_callback};
+  int open_fds = report_pipe[0] >= 0 ? 3 : 2;
+  bool killed = false;
+  char buffer[65536];
+  while (open_fds > 0) {
+    if (!killed && options.cancel != nullptr && options.cancel->load()) {
+      kill(pid, SIGKILL);
+      killed = true;
+    }
+    if (poll(fds, 3, options.cancel != nullptr ? 100 : -1) < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+    for (int i = 0; i < 3; ++i) {
+      if (fds[i].fd < 0 || fds[i].revents == 0) continue;
+      ssize_t count = read(fds[i].fd, buffer, sizeof(buffer));
+      if (count > 0) {
+        if (i < 2) result.output_bytes += count;
+        if (!killed && options.max_output_bytes != 0 &&
+            result.output_bytes > options.max_output_bytes) {
+          kill(pid, SIGKILL);
+          killed = true;
+          result.output_limit_hit = true;
+        }
+        if (*callbacks[i]) {
+          (*callbacks[i])(std::string(buffer, count));
+        } else {
+          sinks[i]->append(buffer, count);
+        }
+      } else if (count == 0 || errno != EINTR) {
+        close(fds[i].fd);
+        fds[i].fd = -1;
+        open_fds--;
+      }
+    }
+  }
+  for (struct pollfd& fd : fds) {
+    if (fd.fd >= 0) close(fd.fd);
+  }
+
+  int status = 0;
+  while (wait4(pid, &status, 0, &result.usage) < 0 && errno == EINTR) {
+  }
+  auto end_time = std::chrono::steady_clock::now();
+
+  result.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       end_time - start_time)
+                       .count();
+  if (counters) {
+    result.counters = counters->Read();
+    result.has_counters = true;
+  }
+  result.user_ns = TimevalToNs(result.usage.ru_utime);
+#ifdef __APPLE__
+  result.peak_rss_bytes = result.usage.ru_maxrss;
+#else
+  result.peak_rss_bytes = result.usage.ru_maxrss * 1024LL;  // Kilobytes
+#endif
+  result.system_ns = TimevalToNs(result.usage.ru_stime);
+  if (WIFEXITED(status)) {
+    result.exit_code = WEXITSTATUS(status);
+  } else if (WIFSIGNALED(status)) {
+    result.term_signal = WTERMSIG(status);
+  }
+  return result;
+}
+
+std::string DescribeExitStatus(const ProcessResult& result) {
+  if (!result.started) {
+    return "failed to start: " + result.error;
+  }
+  if (result.output_limit_hit) {
+    return "killed after exceeding the output limit";
+  }
+  if (result.term_signal != 0) {
+    return "killed by signal " + std::to_string(result.term_signal) + " (" +
+           strsignal(result.term_signal) + ")";
+  }
+  return "exit code " + std::to_string(result.exit_code);
+}
@@ -0,0 +1,69 @@
+// Copyright 2024 Keys
+#ifndef SRC_PROCESS_PROCESS_HPP_
+#define SRC_PROCESS_PROCESS_HPP_
+
+#include <sys/resource.h>
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "perf_counters/perf_counters.hpp"
+
+// Receives child output as it is produced.
+using OutputCallback = std::function<void(const std::string& chunk)>;
+
+struct ProcessOptions {
+  std::string stdin_path = "/dev/null";
+  // When set, output is streamed to the callback instead of being collected
+  // into ProcessResult.
+  OutputCallback on_stdout;
+  OutputCallback on_stderr;
+  // The child is killed with SIGKILL as soon as this becomes true.
+  const std::atomic<bool>* cancel = nullptr;
+  // Count hardware events for the child (see PerfCounterGroup).
+  bool collect_counters = false;
+  // "NAME=value" entries added to the child's environment.
+  std::vector<std::string> extra_env;
+  // Gives the child a pipe as fd 3, collected into ProcessResult::report_data.
+  bool capture_report_fd = false;
+  // The child is killed with SIGKILL once it has written more than this
+  // many bytes to stdout and stderr combined; 0 means no limit.
+  unsigned long long max_output_bytes = 0;  // NOLINT [runtime/int]
+};
+
+struct ProcessResult {
+  bool started = false;
+  std::string error;       // Why the child could not be started
+  int exit_code = -1;      // Valid when the child exited normally
+  int term_signal = 0;     // Non-zero when the child was killed by a signal
+  long long wall_ns = 0;   // NOLINT [runtime/int] Spawn until reap
+  long long user_ns = 0;   // NOLINT [runtime/int]
+  long long system_ns = 0;  // NOLINT [runtime/int]
+  struct rusage usage = {};
+  // From rusage. The kernel seeds a child's maxrss with its parent's RSS at
+  // exec (posix_spawn clones the parent's address space), so this is only
+  // an upper bound unless a more precise source set peak_rss_exact.
+  long long peak_rss_bytes = 0;  // NOLINT [runtime/int]
+  bool peak_rss_exact = false;
+  std::string stdout_data;
+  std::string stderr_data;
+  std::string report_data;
+  unsigned long long output_bytes = 0;  // NOLINT [runtime/int] stdout + stderr
+  bool output_limit_hit = false;  // Killed for exceeding max_output_bytes
+  bool has_counters = false;
+  PerfCounts counters;
+
+  bool Succeeded() const { return started && term_signal == 0 && exit_code == 0; }
+};
+
+// Spawns argv[0] (searched in PATH) with posix_spawn, reading stdout and
+// stderr through separate pipes straight into memory. No shell is involved.
+ProcessResult RunProcess(const std::vector<std::string>& argv,
+                         const ProcessOptions& options = ProcessOptions());
+
+// "exit code 1", "killed by SIGSEGV", ... for status lines.
+std::string DescribeExitStatus(const ProcessResult& result);
+
+#endif  // SRC_PROCESS_PROCESS_HPP_
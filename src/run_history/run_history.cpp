@@ -0,0 +1,298 @@
+// Copyright 2024 Keys
+#include "run_history/run_history.hpp"
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <map>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.hpp"
+#include "compile_cache/compile_cache.hpp"
+#include "hash/hash.hpp"
+#include "precompiled_header/precompiled_header.hpp"
+#include "utils/utils.hpp"
+
+namespace {
+
+// On-disk layout: HistoryHeader, then RunHistoryEntry records until the end
+// of the file.
+constexpr char kMagic[8] = {'L', 'V', 'R', 'U', 'N', 'v', '0', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+struct HistoryHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t record_size;
+};
+
+static_assert(sizeof(RunHistoryEntry) == 112,
+              "RunHistoryEntry is the on-disk record and must not change");
+
+// A regression check looks at the most recent successful runs only, so
+// slow drift in the machine's speed does not accumulate
+constexpr size_t kBaselineRuns = 30;
+constexpr size_t kMinBaselineRuns = 5;
+// Iglewicz and Hoaglin's cut-off for outliers by modified z-score
+constexpr double kRegressionZ = 3.5;
+constexpr double kMinSlowdown = 1.05;
+constexpr size_t kSparklineRuns = 40;
+
+std::string HistoryPath() { return GetCacheRoot() + "/history/runs.log"; }
+
+bool ValidHeader(const HistoryHeader& header) {
+  return std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+         header.version == kVersion &&
+         header.record_size == sizeof(RunHistoryEntry);
+}
+
+// The records parsed so far, grouped by source and profile
+struct HistoryCache {
+  std::mutex mutex;
+  std::uint64_t device = 0;
+  std::uint64_t inode = 0;
+  off_t parsed = 0;  // Bytes of the log already read
+  std::map<std::pair<std::uint64_t, std::uint64_t>,
+           std::vector<RunHistoryEntry>>
+      runs;
+
+  // Reads whatever was appended since the last call. A log that was
+  // replaced or truncated is read again from the start.
+  void Refresh() {
+    int fd = open(HistoryPath().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    // Waits out an append in progress; closing the file releases it
+    struct stat info;
+    if (flock(fd, LOCK_SH) != 0 || fstat(fd, &info) != 0) {
+      close(fd);
+      return;
+    }
+    if (info.st_dev != device || info.st_ino != inode ||
+        info.st_size < parsed) {
+      device = info.st_dev;
+      inode = info.st_ino;
+      parsed = 0;
+      runs.clear();
+    }
+    if (parsed == 0) {
+      HistoryHeader header;
+      if (pread(fd, &header, sizeof(header), 0) != sizeof(header) ||
+          !ValidHeader(header)) {
+        close(fd);
+        return;
+      }
+      parsed = sizeof(header);
+    }
+    // Whole records only; a partial one is still being written or was torn
+    size_t count = (info.st_size - parsed) / sizeof(RunHistoryEntry);
+    std::vector<RunHistoryEntry> records(count);
+    size_t bytes = count * sizeof(RunHistoryEntry);
+    if (count > 0 && pread(fd, records.data(), bytes, parsed) ==
+                         static_cast<ssize_t>(bytes)) {
+      for (const RunHistoryEntry& record : records) {
+        runs[{record.source_hash, record.profile_hash}].push_back(record);
+      }
+      parsed += bytes;
+    }
+    close(fd);
+  }
+};
+
+HistoryCache& Cache() {
+  static HistoryCache cache;
+  return cache;
+}
+
+double Median(std::vector<double> values) {
+  size_t middle = values.size() / 2;
+  std::nth_element(values.begin(), values.begin() + middle, values.end());
+  double upper = values[middle];
+  if (values.size() % 2 == 1) return upper;
+  return (*std::max_element(values.begin(), values.begin() + middle) +
+          upper) /
+         2;
+}
+
+}  // namespace
+
+std::uint64_t RunHistoryProfileHash(const BuildProfile& profile) {
+  Hasher hasher;
+  hasher.Update(profile.compiler.size()).Update(profile.compiler);
+  std::string version = CompilerVersion(profile.compiler);
+  hasher.Update(version.size()).Update(version);
+  // Keyed like the compile cache, so runs with and without the
+  // precompiled prefix are kept apart
+  std::vector<std::string> flags =
+      FlagsWithPrecompiledHeader(profile.compiler, profile.flags);
+  hasher.Update(flags.size());
+  for (const std::string& flag : flags) {
+    hasher.Update(flag.size()).Update(flag);
+  }
+  return hasher.Digest();
+}
+
+RunHistoryEntry MakeRunHistoryEntry(const ProcessResult& result,
+                                    std::uint64_t source_hash,
+                                    std::uint64_t profile_hash) {
+  RunHistoryEntry entry;
+  entry.source_hash = source_hash;
+  entry.profile_hash = profile_hash;
+  entry.finished_at = std::time(nullptr);
+  entry.wall_ns = result.wall_ns;
+  entry.user_ns = result.user_ns;
+  entry.system_ns = result.system_ns;
+  entry.peak_rss_bytes = result.peak_rss_bytes;
+  if (result.peak_rss_exact) entry.flags |= kRunHistoryPeakRssExact;
+  if (result.has_counters) {
+    entry.cycles = result.counters.cycles;
+    entry.instructions = result.counters.instructions;
+    entry.l1d_misses = result.counters.l1d_misses;
+    entry.llc_misses = result.counters.llc_misses;
+    entry.branch_misses = result.counters.branch_misses;
+  }
+  entry.exit_code = result.exit_code;
+  entry.term_signal = result.term_signal;
+  return entry;
+}
+
+bool AppendRunHistory(const RunHistoryEntry& entry) {
+  std::string path = HistoryPath();
+  MakeDirectories(path.substr(0, path.find_last_of('/')));
+  int fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+  if (fd < 0) return false;
+  // Other LeetViewer processes may be appending too
+  if (flock(fd, LOCK_EX) != 0) {
+    close(fd);
+    return false;
+  }
+
+  bool ok = false;
+  struct stat info;
+  HistoryHeader header = {};
+  std::string record(reinterpret_cast<const char*>(&entry), sizeof(entry));
+  if (fstat(fd, &info) != 0) {
+    // Nothing is written
+  } else if (info.st_size == 0) {
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.record_size = sizeof(RunHistoryEntry);
+    record.insert(0, reinterpret_cast<const char*>(&header), sizeof(header));
+    ok = true;
+  } else if (pread(fd, &header, sizeof(header), 0) == sizeof(header) &&
+             ValidHeader(header)) {
+    // Cut off a record torn by a crash so the next ones stay aligned
+    off_t whole = sizeof(header) + (info.st_size - sizeof(header)) /
+                                       sizeof(RunHistoryEntry) *
+                                       sizeof(RunHistoryEntry);
+    ok = whole == info.st_size || ftruncate(fd, whole) == 0;
+  }
+  // A log from another version is left alone
+  ok = ok && write(fd, record.data(), record.size()) ==
+                 static_cast<ssize_t>(record.size());
+  flock(fd, LOCK_UN);
+  close(fd);
+  return ok;
+}
+
+std::vector<RunHistoryEntry> LoadRunHistory(std::uint64_t source_hash,
+                                            std::uint64_t profile_hash) {
+  HistoryCache& cache = Cache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.Refresh();
+  auto it = cache.runs.find({source_hash, profile_hash});
+  if (it == cache.runs.end()) return {};
+  return it->second;
+}
+
+RegressionCheck CheckRegression(const std::vector<RunHistoryEntry>& earlier,
+                                const RunHistoryEntry& run) {
+  RegressionCheck check;
+  std::vector<double> times;
+  for (auto it = earlier.rbegin();
+       it != earlier.rend() && times.size() < kBaselineRuns; ++it) {
+    if (it->Succeeded()) times.push_back(static_cast<double>(it->wall_ns));
+  }
+  if (times.size() < kMinBaselineRuns || !run.Succeeded()) return check;
+
+  double median = Median(times);
+  std::vector<double> deviations;
+  for (double time : times) deviations.push_back(std::fabs(time - median));
+  // 1.4826 makes the median absolute deviation estimate a standard
+  // deviation; the floor keeps identical timings from dividing by zero
+  double spread = std::max(1.4826 * Median(deviations), 0.01 * median);
+  double time = static_cast<double>(run.wall_ns);
+
+  check.baseline_runs = static_cast<int>(times.size());
+  check.median_ns = median;
+  check.ratio = median > 0 ? time / median : 0;
+  check.z_score = spread > 0 ? (time - median) / spread : 0;
+  check.regression =
+      check.z_score > kRegressionZ && check.ratio >= kMinSlowdown;
+  return check;
+}
+
+std::string Sparkline(const std::vector<double>& values) {
+  static const char kLevels[] = "_.:-=+*#";
+  constexpr int kTop = sizeof(kLevels) - 2;
+  if (values.empty()) return "";
+  auto [low, high] = std::minmax_element(values.begin(), values.end());
+  double range = *high - *low;
+  std::string line;
+  for (double value : values) {
+    int level = range > 0 ? static_cast<int>(
+                                std::lround((value - *low) / range * kTop))
+                          : 0;
+    line += kLevels[level];
+  }
+  return line;
+}
+
+std::string FormatRunHistory(const std::vector<RunHistoryEntry>& earlier,
+                             const RunHistoryEntry& run,
+                             const std::string& profile_name) {
+  std::vector<double> times;
+  if (run.Succeeded()) times.push_back(static_cast<double>(run.wall_ns));
+  for (auto it = earlier.rbegin();
+       it != earlier.rend() && times.size() < kSparklineRuns; ++it) {
+    if (it->Succeeded()) times.push_back(static_cast<double>(it->wall_ns));
+  }
+  std::reverse(times.begin(), times.end());
+
+  size_t runs = earlier.size() + 1;
+  std::string text = "History (" + profile_name + "): " +
+                     std::to_string(runs) + (runs == 1 ? " run" : " runs") +
+                     " of this source";
+  if (!times.empty()) {
+    text += ", best " +
+            FormatNanoseconds(*std::min_element(times.begin(), times.end())) +
+            "\n  " + Sparkline(times) + "  last " +
+            std::to_string(times.size()) + " successful, oldest first";
+  }
+  text += "\n";
+  if (!run.Succeeded()) return text;
+
+  RegressionCheck check = CheckRegression(earlier, run);
+  char line[160];
+  if (check.baseline_runs == 0) {
+    snprintf(line, sizeof(line),
+             "Regression check: needs %zu earlier successful runs\n",
+             kMinBaselineRuns);
+  } else {
+    snprintf(line, sizeof(line),
+             "%s: %.2fx the median of the last %d runs (%s), z = %.1f\n",
+             check.regression ? "REGRESSION" : "No regression", check.ratio,
+             check.baseline_runs, FormatNanoseconds(check.median_ns).c_str(),
+             check.z_score);
+  }
+  return text + line;
+}
@@ -0,0 +1,87 @@
+// Copyright 2024 Keys
+#ifndef SRC_RUN_HISTORY_RUN_HISTORY_HPP_
+#define SRC_RUN_HISTORY_RUN_HISTORY_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "build_profile/build_profile.hpp"
+#include "process/process.hpp"
+
+// One run of a solution as stored in the history log. The struct is the
+// on-disk record, so its fields are fixed-width and it has no padding.
+struct RunHistoryEntry {
+  std::uint64_t source_hash = 0;   // HashBytes() of the compiled source
+  std::uint64_t profile_hash = 0;  // RunHistoryProfileHash()
+  std::int64_t finished_at = 0;    // Unix seconds
+  std::int64_t wall_ns = 0;
+  std::int64_t user_ns = 0;
+  std::int64_t system_ns = 0;
+  std::int64_t peak_rss_bytes = 0;
+  // -1 when not counted, as in PerfCounts
+  std::int64_t cycles = -1;
+  std::int64_t instructions = -1;
+  std::int64_t l1d_misses = -1;
+  std::int64_t llc_misses = -1;
+  std::int64_t branch_misses = -1;
+  std::int32_t exit_code = -1;
+  std::int32_t term_signal = 0;
+  std::uint32_t flags = 0;  // kRunHistoryPeakRssExact
+  std::uint32_t reserved = 0;
+
+  bool Succeeded() const { return exit_code == 0 && term_signal == 0; }
+};
+
+constexpr std::uint32_t kRunHistoryPeakRssExact = 1;
+
+// Identifies a compiler, its version and the flags including the
+// precompiled prefix, like the compile cache key without the source.
+std::uint64_t RunHistoryProfileHash(const BuildProfile& profile);
+
+RunHistoryEntry MakeRunHistoryEntry(const ProcessResult& result,
+                                    std::uint64_t source_hash,
+                                    std::uint64_t profile_hash);
+
+// The history is one append-only log under <cache root>/history shared by
+// every LeetViewer process: a small header followed by RunHistoryEntry
+// records. Appends take an flock and are a single write, and a record torn
+// by a crash is cut off before the next append. Readers keep the records
+// they have parsed and only read what was appended since.
+
+// Appends `entry` to the log; false if it could not be written.
+bool AppendRunHistory(const RunHistoryEntry& entry);
+
+// Every recorded run of `source_hash` built with `profile_hash`, oldest
+// first.
+std::vector<RunHistoryEntry> LoadRunHistory(std::uint64_t source_hash,
+                                            std::uint64_t profile_hash);
+
+// How a run's wall time compares with the earlier successful runs of the
+// same source and profile.
+struct RegressionCheck {
+  int baseline_runs = 0;  // Earlier runs compared against; 0 if too few
+  double median_ns = 0;
+  double ratio = 0;     // This run over the median
+  double z_score = 0;   // Robust z-score from the median absolute deviation
+  bool regression = false;
+};
+
+// Flags `run` when it is both well outside the spread of the last few
+// dozen successful `earlier` runs (robust z-score above 3.5) and
+// noticeably slower than their median, so jitter in tiny programs is not
+// reported.
+RegressionCheck CheckRegression(const std::vector<RunHistoryEntry>& earlier,
+                                const RunHistoryEntry& run);
+
+// One character per value, from '_' for the smallest to '#' for the
+// largest.
+std::string Sparkline(const std::vector<double>& values);
+
+// Lines for the output pane: a sparkline of the recent successful runs
+// ending with `run`, and the regression verdict.
+std::string FormatRunHistory(const std::vector<RunHistoryEntry>& earlier,
+                             const RunHistoryEntry& run,
+                             const std::string& profile_name);
+
+#endif  // SRC_RUN_HISTORY_RUN_HISTORY_HPP_
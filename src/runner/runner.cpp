@@ -0,0 +1,442 @@
+// Copyright 2024 Keys
+#include "runner/runner.hpp"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT [build/c++11]
+#include <condition_variable>  // NOLINT [build/c++11]
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <mutex>   // NOLINT [build/c++11]
+#include <set>
+#include <string>
+#include <thread>  // NOLINT [build/c++11]
+#include <vector>
+
+#include "alloc_shim/alloc_shim.hpp"
+#include "benchmark/benchmark.hpp"
+#include "comparison/comparison.hpp"
+#include "compile_cache/compile_cache.hpp"
+#include "hash/hash.hpp"
+#include "output_capture/output_capture.hpp"
+#include "perf_counters/perf_counters.hpp"
+#include "precompiled_header/precompiled_header.hpp"
+#include "run_history/run_history.hpp"
+#include "utils/utils.hpp"
+
+namespace {
+
+std::string FormatDuration(double seconds) {
+  char buffer[32];
+  if (seconds < 1.0) {
+    snprintf(buffer, sizeof(buffer), "%.1f ms", seconds * 1e3);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%.2f s", seconds);
+  }
+  return buffer;
+}
+
+// Cache keys currently being compiled. A second compile of the same key,
+// e.g. a run started while the file menu is still prefetching it, waits for
+// the first one instead of building the binary twice.
+std::mutex g_in_flight_mutex;
+std::condition_variable g_in_flight_done;
+std::set<std::string> g_in_flight;
+
+class InFlightCompile {
+ public:
+  explicit InFlightCompile(const std::string& key) : key_(key) {
+    std::unique_lock<std::mutex> lock(g_in_flight_mutex);
+    g_in_flight_done.wait(lock, [&]() { return !g_in_flight.count(key_); });
+    g_in_flight.insert(key_);
+  }
+  ~InFlightCompile() {
+    std::lock_guard<std::mutex> lock(g_in_flight_mutex);
+    g_in_flight.erase(key_);
+    g_in_flight_done.notify_all();
+  }
+
+ private:
+  std::string key_;
+};
+
+}  // namespace
+
+bool CompileCppFile(const std::string& cpp_file_path,
+                    const BuildProfile& profile, std::string* binary_path,
+                    std::string* diagnostics,
+                    const std::atomic<bool>* cancel,
+                    std::uint64_t* source_hash) {
+  std::ifstream source_stream(cpp_file_path, std::ios::binary);
+  if (!source_stream.is_open()) {
+    *diagnostics = "Error opening file!\n";
+    return false;
+  }
+  std::string source((std::istreambuf_iterator<char>(source_stream)),
+                     std::istreambuf_iterator<char>());
+  if (source_hash != nullptr) *source_hash = HashBytes(source);
+
+  // Reuse a previously built binary when source, compiler and flags match.
+  // The flags include the precompiled prefix, so a build without it (or
+  // with a changed one) never reuses a binary built with it.
+  std::vector<std::string> flags =
+      FlagsWithPrecompiledHeader(profile.compiler, profile.flags);
+  std::string cache_key = CompileCacheKey(source, profile.compiler, flags);
+  *binary_path = CompileCachePath(cache_key);
+  if (CompileCacheLookup(cache_key)) {
+    return true;
+  }
+  InFlightCompile in_flight(cache_key);
+  if (CompileCacheLookup(cache_key)) {  // Built while we were waiting
+    return true;
+  }
+
+  std::string staging_file = CompileCacheStagingPath(cache_key);
+  std::vector<std::string> argv = {profile.compiler};
+  argv.insert(argv.end(), flags.begin(), flags.end());
+  argv.insert(argv.end(), {cpp_file_path, "-o", staging_file});
+
+  ProcessOptions options;
+  options.cancel = cancel;
+  ProcessResult result = RunProcess(argv, options);
+  *diagnostics = result.error + result.stdout_data + result.stderr_data;
+  if (!result.Succeeded() || !CompileCacheStore(cache_key, staging_file)) {
+    unlink(staging_file.c_str());
+    return false;
+  }
+  return true;
+}
+
+ProcessResult RunBinary(const std::string& binary_path,
+                        const ProcessOptions& options,
+                        bool track_allocations) {
+  ProcessOptions run_options = options;
+  run_options.stdin_path = "/dev/null";
+  if (run_options.max_output_bytes == 0) {
+    run_options.max_output_bytes = DefaultOutputLimits().kill_bytes;
+  }
+  if (track_allocations) {
+    std::string shim = FindAllocShim();
+    if (!shim.empty()) {
+      run_options.extra_env.push_back("LD_PRELOAD=" + shim);
+      run_options.extra_env.push_back(std::string(kAllocReportFdEnv) + "=3");
+      run_options.capture_report_fd = true;
+    }
+  }
+  ProcessResult result = RunProcess({binary_path}, run_options);
+
+  // The shim measures the program's own high-water mark, which is exact
+  AllocStats allocs;
+  if (ParseAllocReport(result.report_data, &allocs) && allocs.peak_rss > 0) {
+    result.peak_rss_bytes = allocs.peak_rss;
+    result.peak_rss_exact = true;
+  }
+  return result;
+}
+
+std::string FormatRunSummary(const ProcessResult& result,
+                             std::uint64_t dropped_bytes) {
+  if (!result.started) {
+    return "Error executing program: " + result.error + "\n";
+  }
+  std::string summary;
+  if (!result.stderr_data.empty()) {
+    summary += "\n[stderr]\n" + result.stderr_data;
+  }
+  summary += "\nExecuted in " + std::to_string(result.wall_ns) +
+             " nanoseconds (" + DescribeExitStatus(result) + ", cpu " +
+             FormatDuration((result.user_ns + result.system_ns) / 1e9) + ")\n";
+  if (dropped_bytes > 0 || result.output_limit_hit) {
+    summary += "Output: " +
+               FormatBytes(static_cast<double>(result.output_bytes)) +
+               " written, " + FormatBytes(static_cast<double>(dropped_bytes)) +
+               " dropped" +
+               (result.output_limit_hit ? " (output limit reached)" : "") +
+               "\n";
+  }
+  if (result.has_counters) {
+    summary += "Counters: " + FormatPerfCounts(result.counters) + "\n";
+  }
+  summary += "Memory: peak RSS " + FormatBytes(result.peak_rss_bytes) +
+             (result.peak_rss_exact ? "" : " (upper bound)") +
+             ", page faults " + std::to_string(result.usage.ru_minflt) +
+             " minor / " + std::to_string(result.usage.ru_majflt) +
+             " major\n";
+  AllocStats allocs;
+  if (ParseAllocReport(result.report_data, &allocs)) {
+    summary += "Allocations: " + std::to_string(allocs.allocations) +
+               " allocs / " + std::to_string(allocs.frees) + " frees, " +
+               FormatBytes(allocs.bytes) + " total, peak live " +
+               FormatBytes(allocs.peak_live) + "\n";
+  }
+  return summary;
+}
+
+struct RunSession::State {
+  mutable std::mutex mutex;
+  std::string pending_output;
+  std::atomic<RunStage> stage{RunStage::kCompiling};
+  std::atomic<bool> cancelled{false};
+  std::chrono::steady_clock::time_point stage_start =
+      std::chrono::steady_clock::now();
+  long long duration_ns = 0;  // NOLINT [runtime/int]
+  std::string progress;       // e.g. "5/23" while benchmarking
+  // Totals of the OutputCapture in kRun, updated as output arrives
+  std::atomic<std::uint64_t> captured_bytes{0};
+  std::atomic<std::uint64_t> dropped_bytes{0};
+  bool has_run_result = false;  // kRun only, set before kFinished
+  ProcessResult run_result;
+
+  void Append(const std::string& chunk) {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending_output += chunk;
+  }
+
+  void Enter(RunStage next) {
+    std::lock_guard<std::mutex> lock(mutex);
+    stage_start = std::chrono::steady_clock::now();
+    stage = next;
+  }
+};
+
+RunSession::RunSession(const std::string& cpp_file_path, RunMode mode)
+    : state_(std::make_shared<State>()),
+      mode_(mode),
+      profile_name_(mode == RunMode::kMatrix ? "all profiles"
+                                             : ActiveBuildProfile().name) {
+  std::shared_ptr<State> state = state_;
+  if (mode == RunMode::kMatrix) {
+    std::string baseline = BaselineBuildProfile().name;
+    std::thread([state, cpp_file_path, baseline]() {
+      BenchmarkOptions options = DefaultBenchmarkOptions();
+      auto progress = [&](const std::string& text) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->progress = text;
+      };
+      state->Enter(RunStage::kRunning);
+      auto start_time = std::chrono::steady_clock::now();
+      std::vector<CandidateResult> results =
+          CompareProfiles(cpp_file_path, options, progress, &state->cancelled);
+      state->Append(FormatComparisonTable(
+          results, options,
+          "Profile matrix of " + std::to_string(results.size()) + " builds",
+          baseline));
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->duration_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_time)
+                .count();
+      }
+      state->Enter(RunStage::kFinished);
+    }).detach();
+    return;
+  }
+
+  BuildProfile profile = ActiveBuildProfile();
+  std::thread([state, cpp_file_path, mode, profile]() {
+    std::string binary_path, diagnostics;
+    std::uint64_t source_hash = 0;
+    if (!CompileCppFile(cpp_file_path, profile, &binary_path, &diagnostics,
+                        &state->cancelled, &source_hash)) {
+      state->Append("Compilation failed for " + cpp_file_path + "\n" +
+                    diagnostics);
+      state->Enter(RunStage::kFailed);
+      return;
+    }
+
+    state->Enter(RunStage::kRunning);
+    if (mode == RunMode::kBenchmark) {
+      BenchmarkOptions options = DefaultBenchmarkOptions();
+      BenchmarkStats stats;
+      std::string error;
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->progress = "baseline";
+      }
+      double baseline_ns = EmptyProcessBaselineNs(options);
+      auto progress = [&](int done, int total) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->progress = std::to_string(done) + "/" + std::to_string(total);
+      };
+      if (!RunBenchmark(binary_path, options, &stats, &error, progress,
+                        &state->cancelled)) {
+        state->Append(error + "\n");
+        state->Enter(RunStage::kFailed);
+        return;
+      }
+      stats.baseline_ns = baseline_ns;
+      state->Append(FormatBenchmarkTable(stats, options));
+      {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->duration_ns = static_cast<long long>(  // NOLINT
+            stats.Net(stats.median_ns));
+      }
+      state->Enter(RunStage::kFinished);
+      return;
+    }
+
+    // Only the head and tail of a runaway program's output are kept; stderr
+    // gets a smaller share since it is held in memory until the summary
+    OutputLimits limits = DefaultOutputLimits();
+    OutputCapture capture(
+        limits, [&](const std::string& chunk) { state->Append(chunk); });
+    OutputLimits stderr_limits = limits;
+    stderr_limits.head_bytes =
+        std::min<std::uint64_t>(limits.head_bytes, 1 << 20);
+    stderr_limits.tail_bytes =
+        std::min<std::uint64_t>(limits.tail_bytes, 64 << 10);
+    std::string stderr_text;
+    OutputCapture stderr_capture(
+        stderr_limits, [&](const std::string& chunk) { stderr_text += chunk; });
+    auto update_totals = [&]() {
+      state->captured_bytes =
+          capture.captured_bytes() + stderr_capture.captured_bytes();
+      state->dropped_bytes =
+          capture.dropped_bytes() + stderr_capture.dropped_bytes();
+    };
+
+    ProcessOptions options;
+    options.on_stdout = [&](const std::string& chunk) {
+      capture.Write(chunk);
+      update_totals();
+    };
+    options.on_stderr = [&](const std::string& chunk) {
+      stderr_capture.Write(chunk);
+      update_totals();
+    };
+    options.cancel = &state->cancelled;
+    options.collect_counters = true;
+    options.max_output_bytes = limits.kill_bytes;
+    ProcessResult result = RunBinary(binary_path, options, true);
+    capture.Finish();
+    stderr_capture.Finish();
+    update_totals();
+    result.stderr_data = stderr_text;
+    std::string summary = FormatRunSummary(result, state->dropped_bytes);
+    // A run killed because the view closed says nothing about its speed
+    if (result.started && !state->cancelled) {
+      std::uint64_t profile_hash = RunHistoryProfileHash(profile);
+      RunHistoryEntry entry =
+          MakeRunHistoryEntry(result, source_hash, profile_hash);
+      std::vector<RunHistoryEntry> earlier =
+          LoadRunHistory(source_hash, profile_hash);
+      AppendRunHistory(entry);
+      summary += FormatRunHistory(earlier, entry, profile.name);
+    }
+    state->Append(summary);
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->duration_ns = result.wall_ns;
+      state->has_run_result = true;
+      state->run_result = result;
+    }
+    state->Enter(result.started ? RunStage::kFinished : RunStage::kFailed);
+  }).detach();
+}
+
+RunSession::RunSession(const std::string& problem_dir,
+                       const std::vector<std::string>& files)
+    : state_(std::make_shared<State>()),
+      mode_(RunMode::kCompare),
+      profile_name_(ActiveBuildProfile().name) {
+  std::shared_ptr<State> state = state_;
+  std::thread([state, problem_dir, files]() {
+    BenchmarkOptions options = DefaultBenchmarkOptions();
+    auto progress = [&](const std::string& text) {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->progress = text;
+    };
+    state->Enter(RunStage::kRunning);
+    auto start_time = std::chrono::steady_clock::now();
+    std::vector<CandidateResult> results = CompareApproaches(
+        problem_dir, files, options, progress, &state->cancelled);
+    state->Append(FormatComparisonTable(
+        results, options,
+        "Comparison of " + std::to_string(results.size()) + " approaches"));
+    {
+      std::lock_guard<std::mutex> lock(state->mutex);
+      state->duration_ns =
+          std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now() - start_time)
+              .count();
+    }
+    state->Enter(RunStage::kFinished);
+  }).detach();
+}
+
+RunSession::~RunSession() { state_->cancelled = true; }
+
+bool RunSession::TakeOutput(std::string* chunk) {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  if (state_->pending_output.empty()) {
+    return false;
+  }
+  chunk->swap(state_->pending_output);
+  state_->pending_output.clear();
+  return true;
+}
+
+RunStage RunSession::stage() const { return state_->stage; }
+
+bool RunSession::FinishedRun(ProcessResult* result) const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  if (!state_->has_run_result) return false;
+  *result = state_->run_result;
+  return true;
+}
+
+std::string RunSession::StatusText() const {
+  static const char kSpinner[] = "|/-\\";
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  double elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - state_->stage_start)
+                       .count();
+  char spinner = kSpinner[static_cast<int>(elapsed * 8) % 4];
+  switch (state_->stage.load()) {
+    case RunStage::kCompiling:
+      return std::string("[") + spinner + "] Compiling... " +
+             FormatDuration(elapsed);
+    case RunStage::kRunning:
+      if (mode_ == RunMode::kCompare || mode_ == RunMode::kMatrix) {
+        return std::string("[") + spinner + "] Comparing: " +
+               state_->progress + "... " + FormatDuration(elapsed);
+      }
+      if (mode_ == RunMode::kBenchmark) {
+        return std::string("[") + spinner + "] Benchmarking " +
+               state_->progress + "... " + FormatDuration(elapsed);
+      }
+      return std::string("[") + spinner + "] Running... " +
+             FormatDuration(elapsed) + OutputTotalsText();
+    case RunStage::kFinished:
+      if (mode_ == RunMode::kCompare || mode_ == RunMode::kMatrix) {
+        return "Comparison done in " +
+               FormatDuration(state_->duration_ns / 1e9);
+      }
+      if (mode_ == RunMode::kBenchmark) {
+        return "Benchmark done, net median " +
+               FormatNanoseconds(state_->duration_ns);
+      }
+      return "Finished in " + FormatDuration(state_->duration_ns / 1e9) +
+             OutputTotalsText();
+    case RunStage::kFailed:
+      return "Failed";
+  }
+  return "";
+}
+
+std::string RunSession::OutputTotalsText() const {
+  std::uint64_t captured = state_->captured_bytes;
+  std::uint64_t dropped = state_->dropped_bytes;
+  if (captured == 0) return "";
+  std::string text = ", " + FormatBytes(static_cast<double>(captured)) +
+                     " captured";
+  if (dropped > 0) {
+    text += ", " + FormatBytes(static_cast<double>(dropped)) + " dropped";
+  }
+  return text;
+}
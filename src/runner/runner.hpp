@@ -0,0 +1,89 @@
+// Copyright 2024 Keys
+#ifndef SRC_RUNNER_RUNNER_HPP_
+#define SRC_RUNNER_RUNNER_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "build_profile/build_profile.hpp"
+#include "process/process.hpp"
+
+// Compiles `cpp_file_path` with `profile` through the compile cache. On
+// success stores the cached binary in `binary_path`; otherwise `diagnostics`
+// holds the compiler output. If another thread is already compiling the same
+// source and profile, waits for it and reuses its binary. Setting `cancel`
+// kills the compiler and fails without touching the cache. `source_hash`,
+// if given, receives HashBytes() of the source that was read.
+bool CompileCppFile(const std::string& cpp_file_path,
+                    const BuildProfile& profile, std::string* binary_path,
+                    std::string* diagnostics,
+                    const std::atomic<bool>* cancel = nullptr,
+                    std::uint64_t* source_hash = nullptr);
+
+// Runs a compiled solution with stdin from /dev/null. `options` carries the
+// output callbacks, cancellation flag and what to measure. Unless `options`
+// sets its own limit, the child is killed once its output exceeds
+// DefaultOutputLimits().kill_bytes. With `track_allocations` the
+// allocation-counting shim is preloaded if present.
+ProcessResult RunBinary(const std::string& binary_path,
+                        const ProcessOptions& options,
+                        bool track_allocations = false);
+
+// Captured stderr (if any) followed by the timing, exit status, counter and
+// memory lines, and an output line when `dropped_bytes` of output were not
+// kept or the output limit was reached.
+std::string FormatRunSummary(const ProcessResult& result,
+                             std::uint64_t dropped_bytes = 0);
+
+enum class RunStage { kCompiling, kRunning, kFinished, kFailed };
+
+// kRun shows the program's output; kBenchmark times repeated runs and shows
+// a statistics table instead; kCompare benchmarks every approach of a
+// problem and shows a ranked comparison; kMatrix does the same for one
+// solution built with every installed profile.
+enum class RunMode { kRun, kBenchmark, kCompare, kMatrix };
+
+// A compile-and-run job executing on a background worker thread. The active
+// build profile is captured when the session is created. A kRun session
+// appends its run to the run history and follows the summary with the
+// history and regression verdict for the same source and profile.
+//
+// The UI polls TakeOutput() and StatusText() between key presses. Destroying
+// a session cancels the job, killing the child if it is still running.
+class RunSession {
+ public:
+  explicit RunSession(const std::string& cpp_file_path,
+                      RunMode mode = RunMode::kRun);
+  // Compares all `files` of `problem_dir` (RunMode::kCompare).
+  RunSession(const std::string& problem_dir,
+             const std::vector<std::string>& files);
+  ~RunSession();
+
+  RunSession(const RunSession&) = delete;
+  RunSession& operator=(const RunSession&) = delete;
+
+  // Moves output produced since the last call into `chunk`; returns false if
+  // there was none.
+  bool TakeOutput(std::string* chunk);
+  RunStage stage() const;
+  std::string StatusText() const;
+  // Copies out how the program ended once a kRun session has finished;
+  // false before that and in the other modes.
+  bool FinishedRun(ProcessResult* result) const;
+  // Name of the profile the session builds with ("all profiles" in kMatrix).
+  const std::string& profile_name() const { return profile_name_; }
+
+ private:
+  // ", 64.0 MB captured, 1.2 GB dropped" once a kRun program has output.
+  std::string OutputTotalsText() const;
+
+  struct State;
+  std::shared_ptr<State> state_;
+  RunMode mode_;
+  std::string profile_name_;
+};
+
+#endif  // SRC_RUNNER_RUNNER_HPP_
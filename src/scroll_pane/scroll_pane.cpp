@@ -0,0 +1,83 @@
+// Copyright 2024 Keys
+#include "scroll_pane/scroll_pane.hpp"
+
+#include <ncurses.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+ScrollPane::ScrollPane(WINDOW* win, const std::string& label,
+                       int visible_lines, bool source_code)
+    : win_(win),
+      label_(label),
+      visible_lines_(visible_lines),
+      syntax_(source_code) {
+  // Only the content rows scroll; the top and bottom borders stay put
+  scrollok(win_, TRUE);
+  idlok(win_, TRUE);
+  wsetscrreg(win_, 1, visible_lines_);
+}
+
+void ScrollPane::MarkChanged(int first_changed) {
+  if (changed_from_ < 0 || first_changed < changed_from_) {
+    changed_from_ = first_changed;
+  }
+  syntax_.InvalidateFrom(first_changed);
+}
+
+bool ScrollPane::Render(LineSource* lines) {
+  bool changed_visible =
+      changed_from_ >= 0 && changed_from_ < top_ + visible_lines_;
+  if (drawn_top_ == top_ && !changed_visible) {
+    return false;
+  }
+
+  int first_row = 0, last_row = 0;  // Rows to draw, [first_row, last_row)
+  int delta = top_ - drawn_top_;
+  if (drawn_top_ < 0 || std::abs(delta) >= visible_lines_) {
+    werase(win_);
+    box(win_, 0, 0);
+    mvwprintw(win_, 0, 2, "%s", label_.c_str());
+    last_row = visible_lines_;
+  } else if (delta > 0) {
+    wscrl(win_, delta);
+    first_row = visible_lines_ - delta;
+    last_row = visible_lines_;
+  } else if (delta < 0) {
+    wscrl(win_, delta);
+    last_row = -delta;
+  }
+  for (int row = first_row; row < last_row; ++row) {
+    DrawRow(row, lines);
+  }
+
+  // Changed lines that were already on screen
+  if (changed_visible) {
+    for (int row = std::max(0, changed_from_ - top_); row < visible_lines_;
+         ++row) {
+      if (row < first_row || row >= last_row) DrawRow(row, lines);
+    }
+  }
+
+  drawn_top_ = top_;
+  changed_from_ = -1;
+  wnoutrefresh(win_);
+  return true;
+}
+
+void ScrollPane::DrawRow(int row, LineSource* lines) {
+  int y = row + 1;
+  int width = getmaxx(win_);
+  // Rows exposed by wscrl come back blank, borders included
+  mvwvline(win_, y, 0, ACS_VLINE, 1);
+  mvwhline(win_, y, 1, ' ', width - 2);
+  mvwvline(win_, y, width - 1, ACS_VLINE, 1);
+
+  size_t index = static_cast<size_t>(top_ + row);
+  std::string_view line;
+  if (lines->GetLine(index, &line)) {
+    DrawHighlightedLine(win_, line, syntax_.Spans(lines, index), y);
+  }
+}
@@ -0,0 +1,51 @@
+// Copyright 2024 Keys
+#ifndef SRC_SCROLL_PANE_SCROLL_PANE_HPP_
+#define SRC_SCROLL_PANE_SCROLL_PANE_HPP_
+
+#include <ncurses.h>
+
+#include <string>
+
+#include "line_source/line_source.hpp"
+#include "syntax_highlighting/syntax_highlighting.hpp"
+
+// A boxed window showing a scrollable, syntax-highlighted slice of lines.
+//
+// The pane remembers what it last drew, so Render() only touches rows that
+// changed: scrolling shifts the existing rows with wscrl and draws just the
+// newly exposed lines, and an untouched pane is skipped entirely. Render()
+// stages the window with wnoutrefresh; the caller flushes the frame with a
+// single doupdate().
+class ScrollPane {
+ public:
+  // Content occupies rows 1..visible_lines of `win`, below `label` in the
+  // top border. `source_code` lets highlighting carry comments and raw
+  // strings across lines; leave it off for program output.
+  ScrollPane(WINDOW* win, const std::string& label, int visible_lines,
+             bool source_code = false);
+
+  int top() const { return top_; }
+  int visible_lines() const { return visible_lines_; }
+
+  // Makes `top` the first visible line.
+  void ScrollTo(int top) { top_ = top; }
+  // Lines from index `first_changed` on have new or different content.
+  void MarkChanged(int first_changed);
+
+  // Draws whatever changed since the last call. Returns false if the pane
+  // was already up to date.
+  bool Render(LineSource* lines);
+
+ private:
+  void DrawRow(int row, LineSource* lines);
+
+  WINDOW* win_;
+  std::string label_;
+  int visible_lines_;
+  int top_ = 0;
+  int drawn_top_ = -1;       // Top line on screen; -1 before the first draw
+  int changed_from_ = -1;    // First changed line; -1 if none
+  SyntaxCache syntax_;
+};
+
+#endif  // SRC_SCROLL_PANE_SCROLL_PANE_HPP_
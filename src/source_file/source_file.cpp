@@ -0,0 +1,99 @@
+// Copyright 2024 Keys
+#include "source_file/source_file.hpp"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <list>
+#include <mutex>  // NOLINT [build/c++11]
+#include <string>
+#include <utility>
+
+namespace {
+
+// Files kept loaded after their last viewer closes, most recent first
+constexpr size_t kCachedFiles = 16;
+
+std::int64_t MtimeNs(const struct stat& info) {
+#ifdef __APPLE__
+  return info.st_mtimespec.tv_sec * 1000000000LL + info.st_mtimespec.tv_nsec;
+#else
+  return info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec;
+#endif
+}
+
+std::mutex cache_mutex;
+std::list<std::pair<std::string, std::shared_ptr<SourceFile>>> cache;
+
+}  // namespace
+
+std::shared_ptr<SourceFile> OpenSourceFile(const std::string& path) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return nullptr;
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  for (auto it = cache.begin(); it != cache.end(); ++it) {
+    const SourceFile& file = *it->second;
+    if (it->first == path && file.device_ == info.st_dev &&
+        file.inode_ == info.st_ino &&
+        file.size_ == static_cast<std::uint64_t>(info.st_size) &&
+        file.mtime_ns_ == MtimeNs(info)) {
+      cache.splice(cache.begin(), cache, it);
+      close(fd);
+      return cache.front().second;
+    }
+  }
+
+  std::shared_ptr<SourceFile> file(new SourceFile());
+  file->device_ = info.st_dev;
+  file->inode_ = info.st_ino;
+  file->mtime_ns_ = MtimeNs(info);
+  file->size_ = info.st_size;
+  // Read into memory the file owns, not mapped: an editor that saves by
+  // truncating and rewriting in place would shrink a mapping under its
+  // readers and fault them with SIGBUS
+  file->text_.resize(info.st_size);
+  size_t size = 0;
+  while (size < file->text_.size()) {
+    ssize_t got =
+        read(fd, file->text_.data() + size, file->text_.size() - size);
+    if (got < 0 && errno == EINTR) continue;
+    if (got <= 0) break;
+    size += got;
+  }
+  close(fd);
+  file->text_.resize(size);  // The file may have shrunk since the fstat
+
+  // Split into lines in one pass; a final line without a newline still
+  // counts, and "\r\n" endings are trimmed
+  const char* cursor = file->text_.data();
+  const char* end = cursor + file->text_.size();
+  while (cursor < end) {
+    const char* newline =
+        static_cast<const char*>(std::memchr(cursor, '\n', end - cursor));
+    const char* line_end = newline != nullptr ? newline : end;
+    size_t length = line_end - cursor;
+    if (length > 0 && cursor[length - 1] == '\r') --length;
+    file->lines_.emplace_back(cursor, length);
+    cursor = line_end + 1;
+  }
+
+  for (auto it = cache.begin(); it != cache.end(); ++it) {
+    if (it->first == path) {
+      cache.erase(it);  // An older version of the file
+      break;
+    }
+  }
+  cache.emplace_front(path, file);
+  if (cache.size() > kCachedFiles) cache.pop_back();
+  return file;
+}
@@ -0,0 +1,55 @@
+// Copyright 2024 Keys
+#ifndef SRC_SOURCE_FILE_SOURCE_FILE_HPP_
+#define SRC_SOURCE_FILE_SOURCE_FILE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "line_source/line_source.hpp"
+
+// A source file read into memory once, with a table of its lines as views
+// into that buffer. The code pane and the highlighter read those views
+// directly, so the text is never copied again into per-line strings.
+//
+// The contents are a snapshot owned by the SourceFile: later changes to
+// the file on disk, including truncating it in place, do not affect views
+// that are already open.
+class SourceFile : public LineSource {
+ public:
+  SourceFile(const SourceFile&) = delete;
+  SourceFile& operator=(const SourceFile&) = delete;
+
+  size_t line_count() const { return lines_.size(); }
+  // Line `index` without its line ending.
+  std::string_view line(size_t index) const { return lines_[index]; }
+  std::string_view text() const { return text_; }
+
+  bool GetLine(size_t index, std::string_view* line) override {
+    if (index >= lines_.size()) return false;
+    *line = lines_[index];
+    return true;
+  }
+
+ private:
+  friend std::shared_ptr<SourceFile> OpenSourceFile(const std::string& path);
+  SourceFile() = default;
+
+  std::string text_;
+  std::vector<std::string_view> lines_;  // Views into text_
+  // Identity of the file that was read, to tell whether it changed
+  std::uint64_t device_ = 0;
+  std::uint64_t inode_ = 0;
+  std::int64_t mtime_ns_ = 0;
+  std::uint64_t size_ = 0;
+};
+
+// Reads `path`, or returns the SourceFile from an earlier call if the file
+// has not changed since (same inode, size and mtime); a few recently opened
+// files are kept loaded for that. Returns nullptr if the file cannot be
+// opened.
+std::shared_ptr<SourceFile> OpenSourceFile(const std::string& path);
+
+#endif  // SRC_SOURCE_FILE_SOURCE_FILE_HPP_
@@ -3,13 +3,12 @@
 
 #include <ncurses.h>
 
+#include <algorithm>
 #include <chrono>  // NOLINT [build/c++11]
 #include <cmath>
 #include <cstring>
-#include <thread>  // NOLINT [build/c++11]
-#include <utility>
 
-#include "../colors/colors.hpp"
+#include "utils/utils.hpp"
 
 void DisplayBigText(int x, int y) {
   const char* text[] = {
@@ -29,13 +28,94 @@ void DisplayBigText(int x, int y) {
   }
 }
 
-void RenderSplashScreen() {
-  initscr();
-  noecho();
-  curs_set(FALSE);
-  start_color();
+namespace {
 
-  InitColors();
+// The donut is rendered into an 80x22 character grid
+constexpr int kGridWidth = 80;
+constexpr int kGridHeight = 22;
+constexpr int kGridCells = kGridWidth * kGridHeight;
+
+// Sample angles around the tube (i) and around the ring (j)
+constexpr int kISteps = 315;  // 0 .. 6.28 in steps of 0.02
+constexpr int kJSteps = 90;   // 0 .. 6.28 in steps of 0.07
+
+constexpr int kMaxFrames = 500;
+constexpr auto kFrameDuration = std::chrono::milliseconds(33);  // ~30 FPS
+
+struct SinCosTable {
+  float sin_i[kISteps], cos_i[kISteps];
+  float sin_j[kJSteps], cos_j[kJSteps];
+};
+
+const SinCosTable& Table() {
+  static const SinCosTable table = [] {
+    SinCosTable t;
+    for (int k = 0; k < kISteps; ++k) {
+      t.sin_i[k] = std::sin(k * 0.02f);
+      t.cos_i[k] = std::cos(k * 0.02f);
+    }
+    for (int k = 0; k < kJSteps; ++k) {
+      t.sin_j[k] = std::sin(k * 0.07f);
+      t.cos_j[k] = std::cos(k * 0.07f);
+    }
+    return t;
+  }();
+  return table;
+}
+
+// Renders one frame of the donut rotated by A and B into `grid`
+void RenderDonut(float A, float B, int donut_x, int donut_y, char* grid) {
+  const SinCosTable& table = Table();
+  float z[kGridCells] = {};
+  std::memset(grid, ' ', kGridCells);
+
+  const float e = std::sin(A), g = std::cos(A);
+  const float m = std::cos(B), n = std::sin(B);
+  // Per-sample results of the projection, scattered afterwards
+  float depth[kISteps];
+  int cell_x[kISteps], cell_y[kISteps], luminance[kISteps];
+  for (int j = 0; j < kJSteps; ++j) {
+    const float d = table.cos_j[j], f = table.sin_j[j];
+    const float h = d + 2;
+    // Straight-line arithmetic over the table, which the compiler can
+    // vectorise
+    for (int i = 0; i < kISteps; ++i) {
+      float c = table.sin_i[i], l = table.cos_i[i];
+      float D = 1 / (c * h * e + f * g + 5);
+      float t = c * h * g - f * e;
+      depth[i] = D;
+      cell_x[i] = static_cast<int>(donut_x + 30 * D * (l * h * m - t * n));
+      cell_y[i] = static_cast<int>(donut_y + 15 * D * (l * h * n + t * m));
+      luminance[i] = static_cast<int>(
+          8 * ((f * e - c * d * g) * m - c * d * e - f * g - l * d * n));
+    }
+    for (int i = 0; i < kISteps; ++i) {
+      int x = cell_x[i], y = cell_y[i];
+      if (y <= 0 || y >= kGridHeight || x <= 0 || x >= kGridWidth) continue;
+      int o = x + kGridWidth * y;
+      if (depth[i] > z[o]) {
+        z[o] = depth[i];
+        grid[o] = ".,-~:;=!*#$@"[luminance[i] > 0 ? luminance[i] : 0];
+      }
+    }
+  }
+}
+
+}  // namespace
+
+SplashOptions SplashOptionsFrom(int argc, char** argv) {
+  SplashOptions options;
+  options.enabled = GetEnvLong("LEETVIEWER_NO_SPLASH", 0) == 0;
+  options.budget_ms = std::max(
+      0L, GetEnvLong("LEETVIEWER_SPLASH_MS", options.budget_ms));
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--no-splash") == 0) options.enabled = false;
+  }
+  return options;
+}
+
+void RenderSplashScreen(const SplashOptions& options) {
+  if (!options.enabled || options.budget_ms == 0) return;
   bkgd(COLOR_PAIR(1));
 
   int donut_x = (COLS - 10) / 3;
@@ -43,61 +123,44 @@ void RenderSplashScreen() {
 
   int text_x = COLS / 2;
   int text_y = (LINES + 10) / 2;
+  // The text is drawn once unless the donut can paint over it
+  bool text_overlaps = text_y < kGridHeight && text_x < kGridWidth;
+  DisplayBigText(text_x, text_y);
 
   float A = 0, B = 0;
-  int iterations = 500;
-
-  auto frame_duration = std::chrono::milliseconds(33);  // Approx. 30 FPS
-  auto start_time = std::chrono::high_resolution_clock::now();
-
-  while (iterations--) {
-    float i, j;
-    int k;
-    float z[1760];
-    char b[1760];
-
-    memset(b, 32, 1760);
-    memset(z, 0, 7040);
-    for (j = 0; j < 6.28; j += 0.07) {
-      for (i = 0; i < 6.28; i += 0.02) {
-        float c = sin(i);
-        float d = cos(j);
-        float e = sin(A);
-        float f = sin(j);
-        float g = cos(A);
-        float h = d + 2;
-        float D = 1 / (c * h * e + f * g + 5);
-        float l = cos(i);
-        float m = cos(B);
-        float n = sin(B);
-        float t = c * h * g - f * e;
-        int x = donut_x + 30 * D * (l * h * m - t * n);
-        int y = donut_y + 15 * D * (l * h * n + t * m);
-        int o = x + 80 * y;
-        int N = 8 * ((f * e - c * d * g) * m - c * d * e - f * g - l * d * n);
-        if (22 > y && y > 0 && x > 0 && 80 > x && D > z[o]) {
-          z[o] = D;
-          b[o] = ".,-~:;=!*#$@"[N > 0 ? N : 0];
-        }
+  char grid[kGridCells];
+  char shown[kGridCells];
+  std::memset(shown, ' ', kGridCells);
+
+  auto start_time = std::chrono::steady_clock::now();
+  auto deadline = start_time + std::chrono::milliseconds(options.budget_ms);
+  auto next_frame = start_time;
+  for (int frame = 0; frame < kMaxFrames; ++frame) {
+    RenderDonut(A, B, donut_x, donut_y, grid);
+    // Only cells that differ from the previous frame are touched
+    for (int k = 0; k < kGridCells; ++k) {
+      if (grid[k] != shown[k]) {
+        mvaddch(k / kGridWidth, k % kGridWidth, grid[k]);
+        shown[k] = grid[k];
       }
     }
-
-    clear();
-    for (k = 0; k < 1760; k++) {
-      move(k / 80, k % 80);
-      addch(b[k]);
-    }
-
-    DisplayBigText(text_x, text_y);
-
-    refresh();
+    if (text_overlaps) DisplayBigText(text_x, text_y);
 
     A += 0.04;
     B += 0.02;
 
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto elapsed = end_time - start_time;
-    std::this_thread::sleep_for(frame_duration - elapsed);
+    // Wait for the next frame with a key read, so any key ends the splash.
+    // Frames are paced from a fixed schedule; a slow frame shortens the
+    // next wait instead of pushing every later frame back.
+    next_frame += kFrameDuration;
+    auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) break;
+    auto wait = std::min(next_frame, deadline) - now;
+    timeout(static_cast<int>(std::max<long long>(  // NOLINT [runtime/int]
+        0, std::chrono::duration_cast<std::chrono::milliseconds>(wait)
+               .count())));
+    if (getch() != ERR) break;  // getch() also refreshes the screen
   }
-  endwin();
+  timeout(-1);
+  clear();
 }
@@ -2,6 +2,17 @@
 #ifndef SRC_SPLASH_SCREEN_SPLASH_SCREEN_HPP_
 #define SRC_SPLASH_SCREEN_SPLASH_SCREEN_HPP_
 
-void RenderSplashScreen();
+struct SplashOptions {
+  bool enabled = true;
+  int budget_ms = 3000;  // The animation never runs longer than this
+};
+
+// Defaults overridden by LEETVIEWER_NO_SPLASH=1, LEETVIEWER_SPLASH_MS and a
+// --no-splash argument.
+SplashOptions SplashOptionsFrom(int argc, char** argv);
+
+// Plays the intro animation on the screen set up by TuiSession until the
+// time budget runs out or a key is pressed. The key is consumed.
+void RenderSplashScreen(const SplashOptions& options = SplashOptions());
 
 #endif  // SRC_SPLASH_SCREEN_SPLASH_SCREEN_HPP_
@@ -0,0 +1,213 @@
+// Copyright 2024 Keys
+#include "syntax_highlighting/keywords.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace {
+
+struct KeywordEntry {
+  std::string_view word;
+  KeywordCategory category;
+};
+
+constexpr KeywordCategory kType = KeywordCategory::kType;
+constexpr KeywordCategory kControlFlow = KeywordCategory::kControlFlow;
+constexpr KeywordCategory kKeyword = KeywordCategory::kKeyword;
+constexpr KeywordCategory kPreprocessor = KeywordCategory::kPreprocessor;
+constexpr KeywordCategory kStdlib = KeywordCategory::kStdlib;
+
+// Each word appears once; a duplicate makes the table build fail below.
+constexpr KeywordEntry kKeywords[] = {
+    // Types
+    {"int", kType}, {"float", kType}, {"double", kType}, {"char", kType},
+    {"bool", kType}, {"void", kType}, {"short", kType}, {"long", kType},
+    {"signed", kType}, {"unsigned", kType}, {"wchar_t", kType},
+    {"char8_t", kType}, {"char16_t", kType}, {"char32_t", kType},
+    {"auto", kType}, {"size_t", kType}, {"int8_t", kType},
+    {"int16_t", kType}, {"int32_t", kType}, {"int64_t", kType},
+    {"uint8_t", kType}, {"uint16_t", kType}, {"uint32_t", kType},
+    {"uint64_t", kType},
+    // Control flow
+    {"if", kControlFlow}, {"else", kControlFlow}, {"for", kControlFlow},
+    {"while", kControlFlow}, {"do", kControlFlow}, {"switch", kControlFlow},
+    {"case", kControlFlow}, {"default", kControlFlow},
+    {"break", kControlFlow}, {"continue", kControlFlow},
+    {"return", kControlFlow}, {"goto", kControlFlow}, {"try", kControlFlow},
+    {"catch", kControlFlow}, {"throw", kControlFlow},
+    {"co_await", kControlFlow}, {"co_yield", kControlFlow},
+    {"co_return", kControlFlow},
+    // Other language keywords
+    {"const", kKeyword}, {"static", kKeyword}, {"volatile", kKeyword},
+    {"mutable", kKeyword}, {"inline", kKeyword}, {"explicit", kKeyword},
+    {"extern", kKeyword}, {"register", kKeyword}, {"thread_local", kKeyword},
+    {"noexcept", kKeyword}, {"constexpr", kKeyword}, {"consteval", kKeyword},
+    {"constinit", kKeyword}, {"decltype", kKeyword}, {"nullptr", kKeyword},
+    {"true", kKeyword}, {"false", kKeyword}, {"dynamic_cast", kKeyword},
+    {"static_cast", kKeyword}, {"reinterpret_cast", kKeyword},
+    {"const_cast", kKeyword}, {"typeid", kKeyword}, {"class", kKeyword},
+    {"struct", kKeyword}, {"union", kKeyword}, {"enum", kKeyword},
+    {"namespace", kKeyword}, {"using", kKeyword}, {"typedef", kKeyword},
+    {"public", kKeyword}, {"private", kKeyword}, {"protected", kKeyword},
+    {"virtual", kKeyword}, {"override", kKeyword}, {"final", kKeyword},
+    {"friend", kKeyword}, {"this", kKeyword}, {"operator", kKeyword},
+    {"template", kKeyword}, {"typename", kKeyword}, {"new", kKeyword},
+    {"delete", kKeyword}, {"sizeof", kKeyword}, {"alignof", kKeyword},
+    {"alignas", kKeyword}, {"static_assert", kKeyword},
+    {"concept", kKeyword}, {"requires", kKeyword}, {"import", kKeyword},
+    {"module", kKeyword}, {"export", kKeyword}, {"asm", kKeyword},
+    {"and", kKeyword}, {"and_eq", kKeyword}, {"bitand", kKeyword},
+    {"bitor", kKeyword}, {"compl", kKeyword}, {"not", kKeyword},
+    {"not_eq", kKeyword}, {"or", kKeyword}, {"or_eq", kKeyword},
+    {"xor", kKeyword}, {"xor_eq", kKeyword},
+    // Preprocessor directives ("if" and "else" come from control flow)
+    {"include", kPreprocessor}, {"define", kPreprocessor},
+    {"undef", kPreprocessor}, {"ifdef", kPreprocessor},
+    {"ifndef", kPreprocessor}, {"elif", kPreprocessor},
+    {"endif", kPreprocessor}, {"pragma", kPreprocessor},
+    {"error", kPreprocessor}, {"warning", kPreprocessor},
+    {"line", kPreprocessor}, {"defined", kPreprocessor},
+    // Standard library
+    {"std", kStdlib}, {"cout", kStdlib}, {"cin", kStdlib}, {"cerr", kStdlib},
+    {"clog", kStdlib}, {"endl", kStdlib}, {"string", kStdlib},
+    {"string_view", kStdlib}, {"vector", kStdlib}, {"map", kStdlib},
+    {"set", kStdlib}, {"multimap", kStdlib}, {"multiset", kStdlib},
+    {"unordered_map", kStdlib}, {"unordered_set", kStdlib},
+    {"pair", kStdlib}, {"tuple", kStdlib}, {"array", kStdlib},
+    {"deque", kStdlib}, {"list", kStdlib}, {"queue", kStdlib},
+    {"stack", kStdlib}, {"priority_queue", kStdlib}, {"bitset", kStdlib},
+    {"optional", kStdlib}, {"function", kStdlib}, {"shared_ptr", kStdlib},
+    {"unique_ptr", kStdlib}, {"weak_ptr", kStdlib},
+    {"make_shared", kStdlib}, {"make_unique", kStdlib},
+    {"make_pair", kStdlib}, {"make_tuple", kStdlib}, {"sort", kStdlib},
+    {"min", kStdlib}, {"max", kStdlib}, {"swap", kStdlib},
+    {"move", kStdlib}, {"malloc", kStdlib}, {"free", kStdlib},
+    {"realloc", kStdlib}, {"calloc", kStdlib}, {"printf", kStdlib},
+    {"scanf", kStdlib}, {"fgets", kStdlib}, {"puts", kStdlib},
+    {"getchar", kStdlib}, {"putchar", kStdlib},
+};
+
+constexpr std::size_t kKeywordCount = sizeof(kKeywords) / sizeof(kKeywords[0]);
+constexpr std::size_t kBucketCount = 64;
+constexpr std::size_t kSlotCount = 512;  // Power of two, ~2.5x the keywords
+constexpr std::uint16_t kEmptySlot = 0xffff;
+constexpr std::uint16_t kMaxDisplacement = 4096;
+
+// FNV-1a followed by a 64-bit finalizer so that both halves are well mixed.
+constexpr std::uint64_t KeywordHash(std::string_view word,
+                                    std::uint64_t seed) {
+  std::uint64_t hash = 14695981039346656037ull ^ seed;
+  for (char ch : word) {
+    hash ^= static_cast<unsigned char>(ch);
+    hash *= 1099511628211ull;
+  }
+  hash ^= hash >> 33;
+  hash *= 0xff51afd7ed558ccdull;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+constexpr std::size_t BucketOf(std::uint64_t hash) {
+  return (hash >> 48) % kBucketCount;
+}
+
+constexpr std::size_t SlotOf(std::uint64_t hash, std::uint16_t displacement) {
+  std::uint64_t base = hash & 0xffffffffu;
+  std::uint64_t step = (hash >> 32) | 1;
+  return (base + displacement * step) % kSlotCount;
+}
+
+// Hash-and-displace: every bucket of the first-level hash gets the smallest
+// displacement that moves all its words into free slots.
+struct PerfectHashTable {
+  bool ok = false;
+  std::uint64_t seed = 0;
+  std::uint16_t displacement[kBucketCount] = {};
+  std::uint16_t slots[kSlotCount] = {};
+};
+
+constexpr PerfectHashTable BuildTable(std::uint64_t seed) {
+  PerfectHashTable table;
+  table.seed = seed;
+  for (std::size_t s = 0; s < kSlotCount; ++s) table.slots[s] = kEmptySlot;
+
+  std::uint64_t hashes[kKeywordCount] = {};
+  std::size_t bucket_size[kBucketCount] = {};
+  for (std::size_t i = 0; i < kKeywordCount; ++i) {
+    hashes[i] = KeywordHash(kKeywords[i].word, seed);
+    bucket_size[BucketOf(hashes[i])]++;
+  }
+
+  // Place the most crowded buckets first, while there is the most room
+  bool placed[kBucketCount] = {};
+  for (std::size_t round = 0; round < kBucketCount; ++round) {
+    std::size_t bucket = kBucketCount;
+    for (std::size_t b = 0; b < kBucketCount; ++b) {
+      if (!placed[b] &&
+          (bucket == kBucketCount || bucket_size[b] > bucket_size[bucket])) {
+        bucket = b;
+      }
+    }
+    placed[bucket] = true;
+
+    std::size_t members[kKeywordCount] = {};
+    std::size_t member_count = 0;
+    for (std::size_t i = 0; i < kKeywordCount; ++i) {
+      if (BucketOf(hashes[i]) == bucket) members[member_count++] = i;
+    }
+    if (member_count == 0) continue;
+
+    bool found = false;
+    for (std::uint16_t d = 0; d < kMaxDisplacement && !found; ++d) {
+      found = true;
+      for (std::size_t m = 0; m < member_count && found; ++m) {
+        std::size_t slot = SlotOf(hashes[members[m]], d);
+        found = table.slots[slot] == kEmptySlot;
+        for (std::size_t prev = 0; prev < m && found; ++prev) {
+          found = SlotOf(hashes[members[prev]], d) != slot;
+        }
+      }
+      if (found) {
+        table.displacement[bucket] = d;
+        for (std::size_t m = 0; m < member_count; ++m) {
+          table.slots[SlotOf(hashes[members[m]], d)] =
+              static_cast<std::uint16_t>(members[m]);
+        }
+      }
+    }
+    if (!found) return table;
+  }
+  table.ok = true;
+  return table;
+}
+
+constexpr PerfectHashTable FindTable() {
+  PerfectHashTable table;
+  for (std::uint64_t seed = 0; seed < 16 && !table.ok; ++seed) {
+    table = BuildTable(seed);
+  }
+  return table;
+}
+
+constexpr PerfectHashTable kTable = FindTable();
+static_assert(kTable.ok, "no perfect hash found; duplicate keyword?");
+
+constexpr KeywordCategory Lookup(std::string_view word) {
+  std::uint64_t hash = KeywordHash(word, kTable.seed);
+  std::uint16_t index =
+      kTable.slots[SlotOf(hash, kTable.displacement[BucketOf(hash)])];
+  if (index == kEmptySlot || kKeywords[index].word != word) {
+    return KeywordCategory::kNone;
+  }
+  return kKeywords[index].category;
+}
+
+static_assert(Lookup("int") == KeywordCategory::kType, "");
+static_assert(Lookup("return") == KeywordCategory::kControlFlow, "");
+static_assert(Lookup("unordered_map") == KeywordCategory::kStdlib, "");
+static_assert(Lookup("rowIndex") == KeywordCategory::kNone, "");
+
+}  // namespace
+
+KeywordCategory LookupKeyword(std::string_view word) { return Lookup(word); }
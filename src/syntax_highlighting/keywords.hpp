@@ -0,0 +1,21 @@
+// Copyright 2024 Keys
+#ifndef SRC_SYNTAX_HIGHLIGHTING_KEYWORDS_HPP_
+#define SRC_SYNTAX_HIGHLIGHTING_KEYWORDS_HPP_
+
+#include <cstdint>
+#include <string_view>
+
+enum class KeywordCategory : std::uint8_t {
+  kNone,          // Not a keyword
+  kType,          // Built-in and fixed-width types: int, bool, size_t
+  kControlFlow,   // if, for, return, throw, co_await, ...
+  kKeyword,       // Other language keywords: const, class, template, ...
+  kPreprocessor,  // Directive names; only meaningful after '#'
+  kStdlib,        // Common standard-library names: std, vector, cout, ...
+};
+
+// Category of `word`, looked up in a perfect-hash table generated at compile
+// time. Never allocates.
+KeywordCategory LookupKeyword(std::string_view word);
+
+#endif  // SRC_SYNTAX_HIGHLIGHTING_KEYWORDS_HPP_
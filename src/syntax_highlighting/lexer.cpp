@@ -0,0 +1,264 @@
+// Copyright 2024 Keys
+#include "syntax_highlighting/lexer.hpp"
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+#include "syntax_highlighting/keywords.hpp"
+
+namespace {
+
+bool IsIdentifierStart(char ch) {
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || ch == '_';
+}
+
+bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+bool IsIdentifierChar(char ch) { return IsIdentifierStart(ch) || IsDigit(ch); }
+
+// Appends [begin, end) as `token_class`, growing the previous span when it
+// has the same class. A null `spans` discards it.
+void Emit(std::vector<Span>* spans, size_t begin, size_t end,
+          TokenClass token_class) {
+  if (spans == nullptr || begin == end) return;
+  if (!spans->empty() && spans->back().token_class == token_class) {
+    Span& previous = spans->back();
+    previous.length = static_cast<std::uint32_t>(end - previous.offset);
+    return;
+  }
+  spans->push_back({static_cast<std::uint32_t>(begin),
+                    static_cast<std::uint32_t>(end - begin), token_class});
+}
+
+TokenClass ClassOf(KeywordCategory category) {
+  switch (category) {
+    case KeywordCategory::kType:
+      return TokenClass::kType;
+    case KeywordCategory::kControlFlow:
+      return TokenClass::kControlFlow;
+    case KeywordCategory::kKeyword:
+      return TokenClass::kKeyword;
+    case KeywordCategory::kStdlib:
+      return TokenClass::kStdlib;
+    case KeywordCategory::kPreprocessor:  // Plain outside a directive
+    case KeywordCategory::kNone:
+      break;
+  }
+  return TokenClass::kPlain;
+}
+
+size_t SkipSpaces(std::string_view line, size_t i) {
+  while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) ++i;
+  return i;
+}
+
+bool EndsWithBackslash(std::string_view line) {
+  return !line.empty() && line.back() == '\\';
+}
+
+// Lexes a leading "# directive" and, for #include, the <header> name.
+// Returns where normal lexing continues, or 0 if the line is no directive.
+size_t LexDirective(std::string_view line, std::vector<Span>* spans) {
+  size_t hash = SkipSpaces(line, 0);
+  if (hash == line.size() || line[hash] != '#') return 0;
+  size_t name_begin = SkipSpaces(line, hash + 1);
+  size_t name_end = name_begin;
+  while (name_end < line.size() && IsIdentifierChar(line[name_end])) {
+    ++name_end;
+  }
+  Emit(spans, 0, hash, TokenClass::kPlain);
+  Emit(spans, hash, name_end, TokenClass::kPreprocessor);
+
+  if (line.substr(name_begin, name_end - name_begin) != "include") {
+    return name_end;
+  }
+  size_t header_begin = SkipSpaces(line, name_end);
+  if (header_begin == line.size() || line[header_begin] != '<') {
+    return name_end;
+  }
+  size_t header_end = line.find('>', header_begin);
+  header_end = header_end == std::string_view::npos ? line.size()
+                                                    : header_end + 1;
+  Emit(spans, name_end, header_begin, TokenClass::kPlain);
+  Emit(spans, header_begin, header_end, TokenClass::kString);
+  return header_end;
+}
+
+// Finds the end of an open raw string, i.e. just past )delimiter", starting
+// at `from`; npos if it does not close on this line.
+size_t FindRawStringEnd(std::string_view line, size_t from,
+                        const LexState& state) {
+  std::string_view delimiter(state.delimiter, state.delimiter_length);
+  for (size_t close = line.find(')', from); close != std::string_view::npos;
+       close = line.find(')', close + 1)) {
+    size_t quote = close + 1 + delimiter.size();
+    if (quote < line.size() && line[quote] == '"' &&
+        line.substr(close + 1, delimiter.size()) == delimiter) {
+      return quote + 1;
+    }
+  }
+  return std::string_view::npos;
+}
+
+// If `prefix` (an identifier ending at `quote`) starts a raw string literal
+// R"delim(, records the delimiter in `state` and returns the index just past
+// '('; otherwise returns npos.
+size_t OpenRawString(std::string_view line, std::string_view prefix,
+                     size_t quote, LexState* state) {
+  if (prefix != "R" && prefix != "u8R" && prefix != "uR" && prefix != "UR" &&
+      prefix != "LR") {
+    return std::string_view::npos;
+  }
+  size_t open = quote + 1;
+  while (open < line.size() && open - quote - 1 < LexState::kMaxDelimiter &&
+         line[open] != '(' && line[open] != ')' && line[open] != '\\' &&
+         line[open] != ' ' && line[open] != '"') {
+    ++open;
+  }
+  if (open >= line.size() || line[open] != '(') {
+    return std::string_view::npos;
+  }
+  state->delimiter_length = static_cast<std::uint8_t>(open - quote - 1);
+  line.copy(state->delimiter, state->delimiter_length, quote + 1);
+  return open + 1;
+}
+
+// Shared by LexLine and AdvanceLexState; `spans` is null when only the state
+// is wanted.
+void Lex(std::string_view line, LexState* state, std::vector<Span>* spans) {
+  size_t i = 0;
+  bool in_directive = false;
+
+  // Finish whatever the previous line left open
+  switch (state->mode) {
+    case LexState::Mode::kBlockComment: {
+      size_t end = line.find("*/");
+      if (end == std::string_view::npos) {
+        Emit(spans, 0, line.size(), TokenClass::kComment);
+        return;
+      }
+      i = end + 2;
+      Emit(spans, 0, i, TokenClass::kComment);
+      state->mode = LexState::Mode::kCode;
+      break;
+    }
+    case LexState::Mode::kRawString: {
+      size_t end = FindRawStringEnd(line, 0, *state);
+      if (end == std::string_view::npos) {
+        Emit(spans, 0, line.size(), TokenClass::kString);
+        return;
+      }
+      i = end;
+      Emit(spans, 0, i, TokenClass::kString);
+      state->mode = LexState::Mode::kCode;
+      state->delimiter_length = 0;
+      break;
+    }
+    case LexState::Mode::kLineComment:
+      Emit(spans, 0, line.size(), TokenClass::kComment);
+      if (!EndsWithBackslash(line)) state->mode = LexState::Mode::kCode;
+      return;
+    case LexState::Mode::kDirective:
+      // The macro body continues; a leading '#' here is not a directive
+      in_directive = true;
+      state->mode = LexState::Mode::kCode;
+      break;
+    case LexState::Mode::kCode:
+      i = LexDirective(line, spans);
+      in_directive = i > 0;
+      break;
+  }
+
+  while (i < line.size()) {
+    char ch = line[i];
+    size_t start = i;
+
+    if (ch == '/' && i + 1 < line.size() && line[i + 1] == '/') {
+      Emit(spans, start, line.size(), TokenClass::kComment);
+      if (EndsWithBackslash(line)) state->mode = LexState::Mode::kLineComment;
+      return;
+    }
+
+    if (ch == '/' && i + 1 < line.size() && line[i + 1] == '*') {
+      size_t end = line.find("*/", i + 2);
+      if (end == std::string_view::npos) {
+        Emit(spans, start, line.size(), TokenClass::kComment);
+        state->mode = LexState::Mode::kBlockComment;
+        return;
+      }
+      i = end + 2;
+      Emit(spans, start, i, TokenClass::kComment);
+      continue;
+    }
+
+    if (ch == '"' || ch == '\'') {
+      // Runs to the matching quote, skipping escapes; unterminated literals
+      // end with the line
+      for (++i; i < line.size() && line[i] != ch; ++i) {
+        if (line[i] == '\\') ++i;
+      }
+      i = std::min(i + 1, line.size());
+      Emit(spans, start, i, TokenClass::kString);
+      continue;
+    }
+
+    if (IsDigit(ch)) {
+      // Covers 42, 0x1F, 1e9, 3.14f and 1'000'000
+      while (i < line.size() &&
+             (IsIdentifierChar(line[i]) || line[i] == '.' || line[i] == '\'')) {
+        ++i;
+      }
+      Emit(spans, start, i, TokenClass::kNumber);
+      continue;
+    }
+
+    if (IsIdentifierStart(ch)) {
+      while (i < line.size() && IsIdentifierChar(line[i])) ++i;
+      std::string_view word = line.substr(start, i - start);
+      if (i < line.size() && line[i] == '"') {
+        size_t body = OpenRawString(line, word, i, state);
+        if (body != std::string_view::npos) {
+          size_t end = FindRawStringEnd(line, body, *state);
+          if (end == std::string_view::npos) {
+            Emit(spans, start, line.size(), TokenClass::kString);
+            state->mode = LexState::Mode::kRawString;
+            return;
+          }
+          i = end;
+          state->delimiter_length = 0;
+          Emit(spans, start, i, TokenClass::kString);
+          continue;
+        }
+      }
+      if (spans != nullptr) {
+        Emit(spans, start, i, ClassOf(LookupKeyword(word)));
+      }
+      continue;
+    }
+
+    ++i;
+    Emit(spans, start, i, TokenClass::kPlain);
+  }
+
+  if (in_directive && EndsWithBackslash(line)) {
+    state->mode = LexState::Mode::kDirective;
+  }
+}
+
+}  // namespace
+
+std::vector<Span> LexLine(std::string_view line, LexState* state) {
+  std::vector<Span> spans;
+  Lex(line, state, &spans);
+  return spans;
+}
+
+void AdvanceLexState(std::string_view line, LexState* state) {
+  Lex(line, state, nullptr);
+}
+
+std::vector<Span> LexLine(std::string_view line) {
+  LexState state;
+  return LexLine(line, &state);
+}
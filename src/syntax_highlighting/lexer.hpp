@@ -0,0 +1,64 @@
+// Copyright 2024 Keys
+#ifndef SRC_SYNTAX_HIGHLIGHTING_LEXER_HPP_
+#define SRC_SYNTAX_HIGHLIGHTING_LEXER_HPP_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+enum class TokenClass : std::uint8_t {
+  kPlain,
+  kType,
+  kControlFlow,
+  kKeyword,
+  kPreprocessor,  // '#' and the directive name
+  kStdlib,
+  kString,        // Also header names in #include <...>
+  kComment,
+  kNumber,
+};
+
+// A run of characters of one class: `line.substr(offset, length)`.
+struct Span {
+  std::uint32_t offset;
+  std::uint32_t length;
+  TokenClass token_class;
+};
+
+// What is still open at the end of a line and continues on the next one.
+struct LexState {
+  enum class Mode : std::uint8_t {
+    kCode,
+    kBlockComment,  // Inside /* ... */
+    kRawString,     // Inside R"delimiter( ... )delimiter"
+    kLineComment,   // A // comment continued with a trailing backslash
+    kDirective,     // A preprocessor directive continued with a backslash
+  };
+  static constexpr int kMaxDelimiter = 16;  // Limit set by the standard
+
+  Mode mode = Mode::kCode;
+  std::uint8_t delimiter_length = 0;  // Raw string delimiter
+  char delimiter[kMaxDelimiter] = {};
+
+  bool operator==(const LexState& other) const {
+    return mode == other.mode &&
+           std::string_view(delimiter, delimiter_length) ==
+               std::string_view(other.delimiter, other.delimiter_length);
+  }
+  bool operator!=(const LexState& other) const { return !(*this == other); }
+};
+
+// Splits one line of C++ into spans that cover it completely, in order.
+// Adjacent characters of the same class share a span, so a typical line is
+// only a handful of spans. `state` holds what the previous line left open
+// and is updated to what this line leaves open.
+std::vector<Span> LexLine(std::string_view line, LexState* state);
+
+// Same as LexLine but only computes the resulting state, for skipping over
+// lines that are not displayed.
+void AdvanceLexState(std::string_view line, LexState* state);
+
+// Lexes a line on its own, as if it started a file.
+std::vector<Span> LexLine(std::string_view line);
+
+#endif  // SRC_SYNTAX_HIGHLIGHTING_LEXER_HPP_
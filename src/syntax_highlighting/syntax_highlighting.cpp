@@ -3,298 +3,115 @@
 
 #include <ncurses.h>
 
-#include <regex>  // NOLINT [build/c++11]
+#include <algorithm>
+#include <iterator>
 #include <string>
+#include <vector>
 
-std::unordered_set<std::string> cppKeywords = {"int",
-                                               "float",
-                                               "double",
-                                               "char",
-                                               "bool",
-                                               "void",
-                                               "short",
-                                               "long",
-                                               "signed",
-                                               "unsigned",
-                                               "wchar_t",
-                                               "char16_t",
-                                               "char32_t",
-                                               "auto",
-                                               "decltype",
-                                               "nullptr",
-                                               "if",
-                                               "else",
-                                               "for",
-                                               "while",
-                                               "do",
-                                               "switch",
-                                               "case",
-                                               "default",
-                                               "break",
-                                               "continue",
-                                               "return",
-                                               "const",
-                                               "static",
-                                               "volatile",
-                                               "mutable",
-                                               "inline",
-                                               "explicit",
-                                               "extern",
-                                               "register",
-                                               "thread_local",
-                                               "void",
-                                               "return",
-                                               "inline",
-                                               "noexcept",
-                                               "constexpr",
-                                               "try",
-                                               "catch",
-                                               "throw",
-                                               "noexcept",
-                                               "dynamic_cast",
-                                               "static_cast",
-                                               "reinterpret_cast",
-                                               "const_cast",
-                                               "typeid",
-                                               "class",
-                                               "struct",
-                                               "namespace",
-                                               "public",
-                                               "private",
-                                               "protected",
-                                               "virtual",
-                                               "override",
-                                               "final",
-                                               "friend",
-                                               "this",
-                                               "operator",
-                                               "template",
-                                               "typename",
-                                               "new",
-                                               "delete",
-                                               "sizeof",
-                                               "alignof",
-                                               "alignas",
-                                               "std",
-                                               "cout",
-                                               "cin",
-                                               "cerr",
-                                               "clog",
-                                               "endl",
-                                               "string",
-                                               "vector",
-                                               "map",
-                                               "set",
-                                               "unordered_map",
-                                               "unordered_set",
-                                               "pair",
-                                               "tuple",
-                                               "array",
-                                               "deque",
-                                               "list",
-                                               "queue",
-                                               "stack",
-                                               "priority_queue",
-                                               "bitset",
-                                               "shared_ptr",
-                                               "unique_ptr",
-                                               "weak_ptr",
-                                               "make_shared",
-                                               "make_unique",
-                                               "make_pair",
-                                               "make_tuple",
-                                               "override",
-                                               "final",
-                                               "constexpr",
-                                               "decltype",
-                                               "nullptr",
-                                               "alignof",
-                                               "alignas",
-                                               "static_assert",
-                                               "concept",
-                                               "requires",
-                                               "co_await",
-                                               "co_yield",
-                                               "co_return",
-                                               "import",
-                                               "module",
-                                               "export",
-                                               "char8_t",
-                                               "new",
-                                               "delete",
-                                               "malloc",
-                                               "free",
-                                               "realloc",
-                                               "calloc",
-                                               "cin",
-                                               "cout",
-                                               "cerr",
-                                               "clog",
-                                               "printf",
-                                               "scanf",
-                                               "fgets",
-                                               "puts",
-                                               "getchar",
-                                               "putchar",
-                                               "include",
-                                               "define",
-                                               "undef",
-                                               "if",
-                                               "ifdef",
-                                               "ifndef",
-                                               "else",
-                                               "elif",
-                                               "endif",
-                                               "pragma",
-                                               "error",
-                                               "warning",
-                                               "and",
-                                               "and_eq",
-                                               "bitand",
-                                               "bitor",
-                                               "compl",
-                                               "not",
-                                               "not_eq",
-                                               "or",
-                                               "or_eq",
-                                               "xor",
-                                               "xor_eq",
-                                               "asm",
-                                               "goto",
-                                               "typedef",
-                                               "typeid",
-                                               "namespace",
-                                               "using",
-                                               "std",
-                                               "sizeof",
-                                               "alignof",
-                                               "alignas",
-                                               "static_assert",
-                                               "constexpr",
-                                               "iostream",
-                                               "fstream",
-                                               "sstream",
-                                               "iomanip",
-                                               "ios",
-                                               "istream",
-                                               "ostream",
-                                               "streambuf",
-                                               "locale",
-                                               "algorithm",
-                                               "functional",
-                                               "iterator",
-                                               "numeric",
-                                               "utility",
-                                               "memory",
-                                               "limits",
-                                               "exception",
-                                               "stdexcept",
-                                               "cassert",
-                                               "cctype",
-                                               "cerrno",
-                                               "cfloat",
-                                               "ciso646",
-                                               "climits",
-                                               "clocale",
-                                               "cmath",
-                                               "csetjmp",
-                                               "csignal",
-                                               "cstdarg",
-                                               "cstddef",
-                                               "cstdio",
-                                               "cstdint",
-                                               "cstdlib",
-                                               "cstring",
-                                               "ctime",
-                                               "cwchar",
-                                               "cwctype",
-                                               "array",
-                                               "bitset",
-                                               "deque",
-                                               "list",
-                                               "map",
-                                               "queue",
-                                               "set",
-                                               "stack",
-                                               "vector",
-                                               "unordered_map",
-                                               "unordered_set",
-                                               "complex",
-                                               "random",
-                                               "ratio",
-                                               "regex",
-                                               "chrono",
-                                               "thread",
-                                               "mutex",
-                                               "atomic",
-                                               "condition_variable",
-                                               "future",
-                                               "filesystem",
-                                               "shared_mutex"};
+namespace {
 
-void HighlightSyntax(WINDOW* win, const std::string& line, int line_num) {
-  int x = 2;  // Starting x position for the text
-  std::string word;
-  bool in_string = false;
-  // bool in_comment = false;
+attr_t AttributesFor(TokenClass token_class) {
+  switch (token_class) {
+    case TokenClass::kType:
+      return COLOR_PAIR(11);  // Blue
+    case TokenClass::kControlFlow:
+      return COLOR_PAIR(12) | A_BOLD;  // Red
+    case TokenClass::kKeyword:
+      return COLOR_PAIR(7);  // Yellow
+    case TokenClass::kPreprocessor:
+      return COLOR_PAIR(13) | A_BOLD;  // Magenta
+    case TokenClass::kStdlib:
+      return COLOR_PAIR(14) | A_BOLD;  // Cyan
+    case TokenClass::kString:
+      return COLOR_PAIR(8);  // Magenta
+    case TokenClass::kComment:
+      return COLOR_PAIR(9);  // Green
+    case TokenClass::kNumber:
+      return COLOR_PAIR(10);  // Cyan
+    case TokenClass::kPlain:
+      break;
+  }
+  return A_NORMAL;
+}
 
-  for (size_t i = 0; i < line.length(); ++i) {
-    char ch = line[i];
+}  // namespace
 
-    // Handle comments
-    if (!in_string && ch == '/' && i + 1 < line.length() &&
-        line[i + 1] == '/') {
-      // in_comment = true;
-      wattron(win, COLOR_PAIR(9));  // Highlight comments in green
-      mvwprintw(win, line_num, x, "%s", line.substr(i).c_str());
-      wattroff(win, COLOR_PAIR(9));
-      break;  // End processing for this line
-    }
+const std::vector<Span>& SyntaxCache::Spans(LineSource* lines,
+                                            size_t index) {
+  auto cached = entries_.find(index);
+  if (cached != entries_.end()) {
+    return cached->second.spans;
+  }
 
-    // Handle strings
-    if (ch == '"') {
-      in_string = !in_string;
-      wattron(win, COLOR_PAIR(8));  // Highlight strings in magenta
-      mvwprintw(win, line_num, x, "%c", ch);
-      wattroff(win, COLOR_PAIR(8));
-      x += 1;
-      continue;
-    }
+  LexState state = carry_state_ ? StateAt(lines, index) : LexState();
+  if (entries_.size() >= kMaxCachedLines) {
+    entries_.clear();  // Checkpoints keep re-lexing cheap
+  }
+  std::string_view line;
+  lines->GetLine(index, &line);
+  Entry& entry = entries_[index];
+  entry.spans = LexLine(line, &state);
+  entry.end_state = state;
+  return entry.spans;
+}
 
-    if (in_string) {
-      mvwprintw(win, line_num, x, "%c", ch);
-      x += 1;
-      continue;
-    }
+void SyntaxCache::InvalidateFrom(size_t index) {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    it = it->first >= index ? entries_.erase(it) : std::next(it);
+  }
+  // A checkpoint depends only on the lines above it
+  size_t keep = index / kCheckpointInterval + 1;
+  if (keep < checkpoints_.size()) {
+    checkpoints_.resize(keep);
+  }
+}
 
-    // Handle keywords and numbers
-    if (isspace(ch) || ispunct(ch)) {
-      if (!word.empty()) {
-        if (cppKeywords.find(word) != cppKeywords.end()) {
-          wattron(win, COLOR_PAIR(7));  // Highlight keywords in yellow
-        } else if (std::regex_match(word, std::regex("^[0-9]+$"))) {
-          wattron(win, COLOR_PAIR(10));  // Highlight numbers in cyan
-        }
-        mvwprintw(win, line_num, x - word.length(), "%s", word.c_str());
-        wattroff(win, COLOR_PAIR(7));
-        wattroff(win, COLOR_PAIR(10));
-        word.clear();
-      }
-      mvwprintw(win, line_num, x, "%c", ch);
-    } else {
-      word += ch;
-    }
-    x += 1;
+LexState SyntaxCache::StateAt(LineSource* lines, size_t index) {
+  if (index == 0) {
+    return LexState();
+  }
+  // Usually the line above was just lexed while scrolling
+  auto above = entries_.find(index - 1);
+  if (above != entries_.end()) {
+    return above->second.end_state;
   }
 
-  if (!word.empty()) {
-    if (cppKeywords.find(word) != cppKeywords.end()) {
-      wattron(win, COLOR_PAIR(7));  // Highlight keywords in yellow
-    } else if (std::regex_match(word, std::regex("^[0-9]+$"))) {
-      wattron(win, COLOR_PAIR(10));  // Highlight numbers in cyan
+  if (checkpoints_.empty()) {
+    checkpoints_.push_back(LexState());
+  }
+  std::string_view line;
+  size_t wanted = index / kCheckpointInterval;
+  while (checkpoints_.size() <= wanted) {
+    LexState state = checkpoints_.back();
+    size_t begin = (checkpoints_.size() - 1) * kCheckpointInterval;
+    for (size_t i = begin; i < begin + kCheckpointInterval; ++i) {
+      lines->GetLine(i, &line);
+      AdvanceLexState(line, &state);
     }
-    mvwprintw(win, line_num, x - word.length(), "%s", word.c_str());
-    wattroff(win, COLOR_PAIR(7));
-    wattroff(win, COLOR_PAIR(10));
+    checkpoints_.push_back(state);
+  }
+
+  LexState state = checkpoints_[wanted];
+  for (size_t i = wanted * kCheckpointInterval; i < index; ++i) {
+    lines->GetLine(i, &line);
+    AdvanceLexState(line, &state);
+  }
+  return state;
+}
+
+void DrawHighlightedLine(WINDOW* win, std::string_view line,
+                         const std::vector<Span>& spans, int line_num) {
+  const int x = 2;  // Starting x position for the text
+  const int right = getmaxx(win) - 1;  // Stop before the right border
+  wmove(win, line_num, x);
+  for (const Span& span : spans) {
+    // Measured from the cursor, since tabs take more than one column
+    int room = right - getcurx(win);
+    if (room <= 0 || getcury(win) != line_num) break;
+    int length = std::min(static_cast<int>(span.length), room);
+    attr_t attributes = AttributesFor(span.token_class);
+    if (attributes != A_NORMAL) wattron(win, attributes);
+    waddnstr(win, line.data() + span.offset, length);
+    if (attributes != A_NORMAL) wattroff(win, attributes);
   }
 }
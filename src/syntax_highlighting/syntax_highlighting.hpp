@@ -5,10 +5,50 @@
 #include <ncurses.h>
 
 #include <string>
-#include <unordered_set>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
-extern std::unordered_set<std::string> cppKeywords;
+#include "line_source/line_source.hpp"
+#include "syntax_highlighting/lexer.hpp"
 
-void HighlightSyntax(WINDOW* win, const std::string& line, int line_num);
+// Lexed spans for the lines of one window's content.
+//
+// Spans are kept per line until InvalidateFrom() reports a change, for at
+// most kMaxCachedLines lines around what was recently shown. With
+// `carry_state` (source code) lines are lexed with the state left open by
+// the line before, so block comments and raw strings span lines; the state
+// at every kCheckpointInterval-th line is remembered, so showing a line far
+// down the file resumes from the nearest checkpoint instead of the top.
+// Without it (program output) every line is lexed on its own.
+class SyntaxCache {
+ public:
+  static constexpr size_t kCheckpointInterval = 256;
+  static constexpr size_t kMaxCachedLines = 4096;
+
+  explicit SyntaxCache(bool carry_state = true) : carry_state_(carry_state) {}
+
+  // Spans of line `index` of `lines`, which must exist.
+  const std::vector<Span>& Spans(LineSource* lines, size_t index);
+  // Lines from `index` on have changed.
+  void InvalidateFrom(size_t index);
+
+ private:
+  struct Entry {
+    LexState end_state;  // State after the line, for the line below
+    std::vector<Span> spans;
+  };
+
+  LexState StateAt(LineSource* lines, size_t index);
+
+  bool carry_state_;
+  std::unordered_map<size_t, Entry> entries_;
+  std::vector<LexState> checkpoints_;  // [k]: state at line k * interval
+};
+
+// Draws `line` at row `line_num`, one waddnstr per span, clipped to the
+// window's inner width.
+void DrawHighlightedLine(WINDOW* win, std::string_view line,
+                         const std::vector<Span>& spans, int line_num);
 
 #endif  // SRC_SYNTAX_HIGHLIGHTING_SYNTAX_HIGHLIGHTING_HPP_
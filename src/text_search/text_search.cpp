@@ -0,0 +1,325 @@
+// Copyright 2024 Keys
+#include "text_search/text_search.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>              // NOLINT [build/c++11]
+#include <condition_variable>  // NOLINT [build/c++11]
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>  // NOLINT [build/c++11]
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>  // NOLINT [build/c++11]
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "problem_index/problem_index.hpp"
+#include "source_file/source_file.hpp"
+
+namespace {
+
+// How often the worker checks the ProblemIndex for changes
+constexpr auto kPollInterval = std::chrono::milliseconds(500);
+// Matches counted per file for ranking. Counting stops there, so a query
+// found in every file only reads the start of each.
+constexpr int kCountedMatches = 4;
+
+char LowerByte(char ch) {
+  return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+}
+
+std::string Lowercase(std::string_view text) {
+  std::string lowered(text);
+  for (char& ch : lowered) ch = LowerByte(ch);
+  return lowered;
+}
+
+bool IsWordChar(char ch) {
+  return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') ||
+         (ch >= '0' && ch <= '9') || ch == '_';
+}
+
+// True if [begin, end) of `text` is not part of a longer identifier
+bool IsWholeWord(std::string_view text, size_t begin, size_t end) {
+  return (begin == 0 || !IsWordChar(text[begin - 1])) &&
+         (end == text.size() || !IsWordChar(text[end]));
+}
+
+// The distinct three-byte sequences of `text`, sorted
+std::vector<std::uint32_t> Trigrams(std::string_view text) {
+  std::vector<std::uint32_t> trigrams;
+  if (text.size() < 3) return trigrams;
+  trigrams.reserve(text.size() - 2);
+  std::uint32_t window = static_cast<unsigned char>(text[0]) << 8 |
+                         static_cast<unsigned char>(text[1]);
+  for (size_t i = 2; i < text.size(); ++i) {
+    window = (window << 8 | static_cast<unsigned char>(text[i])) & 0xffffff;
+    trigrams.push_back(window);
+  }
+  std::sort(trigrams.begin(), trigrams.end());
+  trigrams.erase(std::unique(trigrams.begin(), trigrams.end()),
+                 trigrams.end());
+  return trigrams;
+}
+
+bool ReadFile(const std::string& path, std::string* content) {
+  std::ifstream stream(path, std::ios::binary);
+  if (!stream) return false;
+  std::ostringstream buffer;
+  buffer << stream.rdbuf();
+  *content = buffer.str();
+  return true;
+}
+
+// Fills hit->lines with the first `max_lines` lines of `file` containing
+// `needle` (lowercase) and counts all of them in hit->match_count
+void CollectLines(const SourceFile& file, const std::string& needle,
+                  size_t max_lines, SearchHit* hit) {
+  for (size_t number = 0; number < file.line_count(); ++number) {
+    std::string_view line = file.line(number);
+    std::string lowered = Lowercase(line);
+    size_t at = lowered.find(needle);
+    if (at == std::string::npos) continue;
+    ++hit->match_count;
+    if (hit->lines.size() >= max_lines) continue;
+
+    // A query that starts with blanks may match inside the indentation
+    size_t indent = std::min(line.find_first_not_of(" \t"), at);
+    SearchLine match;
+    match.number = static_cast<int>(number);
+    match.text = line.substr(indent);
+    std::replace(match.text.begin(), match.text.end(), '\t', ' ');
+    for (; at != std::string::npos; at = lowered.find(needle, at + 1)) {
+      int begin = static_cast<int>(at - indent);
+      match.matches.emplace_back(begin,
+                                 begin + static_cast<int>(needle.size()));
+    }
+    hit->lines.push_back(std::move(match));
+  }
+}
+
+struct Document {
+  std::string path;
+  std::string lowered_path;
+  std::uint64_t hash = 0;
+  std::string lowered;  // Contents, lowercased
+  bool live = false;
+};
+
+}  // namespace
+
+struct TextSearch::State {
+  std::string root;
+  ProblemIndex* index = nullptr;
+
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::atomic<bool> stopped{false};
+  std::once_flag started;
+  std::thread worker;
+
+  std::vector<Document> documents;  // By id
+  std::vector<std::uint32_t> free_ids;
+  std::unordered_map<std::string, std::uint32_t> ids;  // Path -> id
+  // Trigram -> sorted ids of the documents containing it
+  std::unordered_map<std::uint32_t, std::vector<std::uint32_t>> postings;
+  std::atomic<size_t> indexed{0};
+  std::atomic<bool> ready{false};
+
+  // Both expect `mutex` to be held
+  void Add(const std::string& path, std::uint64_t hash, std::string lowered) {
+    std::uint32_t id;
+    if (free_ids.empty()) {
+      id = static_cast<std::uint32_t>(documents.size());
+      documents.emplace_back();
+    } else {
+      id = free_ids.back();
+      free_ids.pop_back();
+    }
+    for (std::uint32_t trigram : Trigrams(lowered)) {
+      std::vector<std::uint32_t>& list = postings[trigram];
+      list.insert(std::lower_bound(list.begin(), list.end(), id), id);
+    }
+    documents[id] = Document{path, Lowercase(path), hash, std::move(lowered),
+                             true};
+    ids[path] = id;
+  }
+
+  void Remove(std::uint32_t id) {
+    Document& document = documents[id];
+    for (std::uint32_t trigram : Trigrams(document.lowered)) {
+      auto it = postings.find(trigram);
+      if (it == postings.end()) continue;
+      std::vector<std::uint32_t>& list = it->second;
+      auto at = std::lower_bound(list.begin(), list.end(), id);
+      if (at != list.end() && *at == id) list.erase(at);
+      if (list.empty()) postings.erase(it);
+    }
+    ids.erase(document.path);
+    document = Document();
+    free_ids.push_back(id);
+  }
+
+  // Brings the documents in line with the ProblemIndex, reading only files
+  // that are new or whose content hash changed
+  void Sync() {
+    std::vector<std::pair<std::string, std::uint64_t>> solutions =
+        index->Solutions();
+    std::vector<std::pair<std::string, std::uint64_t>> changed;
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      std::unordered_set<std::string> present;
+      for (const auto& [path, hash] : solutions) {
+        present.insert(path);
+        auto it = ids.find(path);
+        if (it == ids.end() || documents[it->second].hash != hash) {
+          changed.emplace_back(path, hash);
+        }
+      }
+      std::vector<std::uint32_t> gone;
+      for (const auto& [path, id] : ids) {
+        if (present.count(path) == 0) gone.push_back(id);
+      }
+      for (std::uint32_t id : gone) Remove(id);
+      indexed = ids.size();
+    }
+
+    for (const auto& [path, hash] : changed) {
+      if (stopped) return;
+      std::string content;
+      if (!ReadFile(root + "/" + path, &content)) continue;
+      std::string lowered = Lowercase(content);
+      std::lock_guard<std::mutex> lock(mutex);
+      auto it = ids.find(path);
+      if (it != ids.end()) Remove(it->second);
+      Add(path, hash, std::move(lowered));
+      indexed = ids.size();
+    }
+  }
+
+  void Run() {
+    bool synced = false;
+    std::uint64_t synced_version = 0;
+    while (!stopped) {
+      std::uint64_t version = index->version();
+      if (!synced || version != synced_version) {
+        synced = true;
+        synced_version = version;
+        Sync();
+        ready = true;
+      }
+      std::unique_lock<std::mutex> lock(mutex);
+      wake.wait_for(lock, kPollInterval, [this]() { return stopped.load(); });
+    }
+  }
+};
+
+TextSearch::TextSearch(const std::string& root, ProblemIndex* index)
+    : state_(std::make_unique<State>()) {
+  state_->root = root;
+  state_->index = index;
+}
+
+TextSearch::~TextSearch() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stopped = true;
+  }
+  state_->wake.notify_one();
+  if (state_->worker.joinable()) state_->worker.join();
+}
+
+std::vector<SearchHit> TextSearch::Search(const std::string& query,
+                                          size_t max_hits) {
+  State* state = state_.get();
+  // Nothing is read until search is first used
+  std::call_once(state->started, [state]() {
+    state->worker = std::thread([state]() { state->Run(); });
+  });
+
+  std::string needle = Lowercase(query);
+  if (needle.empty()) return {};
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  std::vector<std::uint32_t> candidates;
+  if (needle.size() >= 3) {
+    // Intersect the trigram lists, shortest first
+    std::vector<const std::vector<std::uint32_t>*> lists;
+    for (std::uint32_t trigram : Trigrams(needle)) {
+      auto it = state->postings.find(trigram);
+      if (it == state->postings.end()) return {};
+      lists.push_back(&it->second);
+    }
+    std::sort(lists.begin(), lists.end(), [](const auto* a, const auto* b) {
+      return a->size() < b->size();
+    });
+    candidates = *lists[0];
+    for (size_t i = 1; i < lists.size() && !candidates.empty(); ++i) {
+      std::vector<std::uint32_t> both;
+      std::set_intersection(candidates.begin(), candidates.end(),
+                            lists[i]->begin(), lists[i]->end(),
+                            std::back_inserter(both));
+      candidates = std::move(both);
+    }
+  } else {
+    for (std::uint32_t id = 0; id < state->documents.size(); ++id) {
+      if (state->documents[id].live) candidates.push_back(id);
+    }
+  }
+
+  // Having every trigram does not mean having them in a row
+  std::vector<std::pair<int, std::uint32_t>> ranked;  // Score, id
+  for (std::uint32_t id : candidates) {
+    const Document& document = state->documents[id];
+    std::string_view text = document.lowered;
+    int matches = 0, whole_words = 0;
+    for (size_t at = text.find(needle);
+         at != std::string_view::npos && matches < kCountedMatches;
+         at = text.find(needle, at + 1)) {
+      ++matches;
+      if (IsWholeWord(text, at, at + needle.size())) ++whole_words;
+    }
+    if (matches == 0) continue;
+    int score = matches + 4 * whole_words;
+    if (document.lowered_path.find(needle) != std::string::npos) score += 100;
+    ranked.emplace_back(score, id);
+  }
+
+  size_t keep = std::min(max_hits, ranked.size());
+  const std::vector<Document>& documents = state->documents;
+  std::partial_sort(ranked.begin(), ranked.begin() + keep, ranked.end(),
+                    [&](const auto& a, const auto& b) {
+                      return a.first != b.first
+                                 ? a.first > b.first
+                                 : documents[a.second].path <
+                                       documents[b.second].path;
+                    });
+  std::vector<SearchHit> hits(keep);
+  for (size_t i = 0; i < keep; ++i) {
+    hits[i].path = documents[ranked[i].second].path;
+    hits[i].score = ranked[i].first;
+  }
+  return hits;
+}
+
+void TextSearch::FindLines(const std::string& query, size_t max_lines,
+                           SearchHit* hit) const {
+  hit->lines.clear();
+  hit->match_count = 0;
+  std::string needle = Lowercase(query);
+  if (needle.empty()) return;
+  // The file stays cached, so opening the hit afterwards reuses it
+  std::shared_ptr<SourceFile> file =
+      OpenSourceFile(state_->root + "/" + hit->path);
+  if (file) CollectLines(*file, needle, max_lines, hit);
+}
+
+size_t TextSearch::indexed_files() const { return state_->indexed; }
+
+bool TextSearch::ready() const { return state_->ready; }
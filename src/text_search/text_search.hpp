@@ -0,0 +1,64 @@
+// Copyright 2024 Keys
+#ifndef SRC_TEXT_SEARCH_TEXT_SEARCH_HPP_
+#define SRC_TEXT_SEARCH_TEXT_SEARCH_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+class ProblemIndex;
+
+// One line of a solution that contains the query.
+struct SearchLine {
+  int number = 0;    // 0-based
+  std::string text;  // Leading whitespace removed
+  std::vector<std::pair<int, int>> matches;  // [begin, end) columns in text
+};
+
+struct SearchHit {
+  std::string path;  // "<problem>/<file>" below the root
+  int score = 0;
+  // Filled in by TextSearch::FindLines()
+  int match_count = 0;            // Lines containing the query
+  std::vector<SearchLine> lines;  // The first few of them
+};
+
+// Case-insensitive substring search over every solution in a ProblemIndex.
+//
+// Each file's lowercased contents are kept in memory together with a
+// trigram index: a map from every three-byte sequence to the sorted ids of
+// the files containing it. A query of three or more bytes only looks at the
+// files in the intersection of its trigrams' lists. A background thread
+// builds the index on first use and afterwards re-reads just the files
+// whose content hash changed in the ProblemIndex, so edits, new files and
+// deletions show up within a second.
+class TextSearch {
+ public:
+  // `index` must outlive the search.
+  TextSearch(const std::string& root, ProblemIndex* index);
+  ~TextSearch();
+
+  TextSearch(const TextSearch&) = delete;
+  TextSearch& operator=(const TextSearch&) = delete;
+
+  // Up to `max_hits` files containing `query`, best first: whole-word
+  // matches count more than partial ones, and a match in the file's path
+  // more than any.
+  std::vector<SearchHit> Search(const std::string& query, size_t max_hits);
+  // Reads `hit`'s file as it is now and fills in up to `max_lines` of its
+  // lines containing `query`. Meant for the hits actually on screen.
+  void FindLines(const std::string& query, size_t max_lines,
+                 SearchHit* hit) const;
+
+  // Files indexed so far, and whether the first pass is complete.
+  size_t indexed_files() const;
+  bool ready() const;
+
+ private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+#endif  // SRC_TEXT_SEARCH_TEXT_SEARCH_HPP_
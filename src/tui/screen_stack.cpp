@@ -0,0 +1,40 @@
+// Copyright 2024 Keys
+#include "tui/screen_stack.hpp"
+
+#include <ncurses.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "compositor/compositor.hpp"
+
+void RunScreenStack(std::unique_ptr<Screen> root) {
+  std::vector<std::unique_ptr<Screen>> stack;
+  stack.push_back(std::move(root));
+  stack.back()->Show();
+  Compose();
+
+  while (!stack.empty()) {
+    int ch = wgetch(stack.back()->input_window());
+    Transition transition = stack.back()->HandleKey(ch);
+    switch (transition.kind) {
+      case Transition::kStay:
+        break;
+      case Transition::kPush:
+        stack.back()->Hide();
+        stack.push_back(std::move(transition.next));
+        stack.back()->Show();
+        break;
+      case Transition::kPop:
+        stack.pop_back();
+        if (!stack.empty()) stack.back()->Show();
+        break;
+      case Transition::kQuit:
+        // Close from the top down, the same order as going back
+        while (!stack.empty()) stack.pop_back();
+        break;
+    }
+    Compose();
+  }
+}
@@ -0,0 +1,51 @@
+// Copyright 2024 Keys
+#ifndef SRC_TUI_SCREEN_STACK_HPP_
+#define SRC_TUI_SCREEN_STACK_HPP_
+
+#include <ncurses.h>
+
+#include <memory>
+#include <utility>
+
+class Screen;
+
+// What a screen asks the stack to do after handling a key.
+struct Transition {
+  enum Kind { kStay, kPush, kPop, kQuit };
+
+  Kind kind = kStay;
+  std::unique_ptr<Screen> next;  // The screen to open for kPush
+
+  static Transition Stay() { return Transition(); }
+  static Transition Pop() { return Transition{kPop, nullptr}; }
+  static Transition Quit() { return Transition{kQuit, nullptr}; }
+  static Transition Push(std::unique_ptr<Screen> screen) {
+    return Transition{kPush, std::move(screen)};
+  }
+};
+
+// One level of navigation: the problem list, a problem's file list, the
+// code view, ... Screens keep their windows and state while they are
+// covered by the screens pushed over them, so going back only repaints.
+class Screen {
+ public:
+  virtual ~Screen() = default;
+
+  // Window keys are read from; its timeout decides how often HandleKey()
+  // runs without input.
+  virtual WINDOW* input_window() = 0;
+  // Repaints everything, when the screen is first pushed and whenever it
+  // is uncovered again.
+  virtual void Show() = 0;
+  // Hides the screen while one pushed over it is open.
+  virtual void Hide() = 0;
+  // Handles one key, or ERR when the input timeout expired.
+  virtual Transition HandleKey(int ch) = 0;
+};
+
+// Runs screens starting from `root` until the last one is popped or one
+// quits. Screens draw into compositor layers and stage them with
+// wnoutrefresh; the stack composes and flushes each pass with Compose().
+void RunScreenStack(std::unique_ptr<Screen> root);
+
+#endif  // SRC_TUI_SCREEN_STACK_HPP_
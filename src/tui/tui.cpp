@@ -5,136 +5,62 @@
 
 #include <algorithm>
 #include <chrono>  // NOLINT [build/c++11]
+#include <cstdio>
+#include <cstring>
 #include <fstream>
-#include <iostream>
-#include <sstream>
+#include <map>
+#include <memory>
 #include <thread>  // NOLINT [build/c++11]
+#include <utility>
 
+#include "benchmark/benchmark.hpp"
+#include "build_profile/build_profile.hpp"
 #include "colors/colors.hpp"
-#include "file_handler/file_handler.hpp"
+#include "compositor/compositor.hpp"
+#include "fuzzy_filter/fuzzy_filter.hpp"
+#include "line_source/line_source.hpp"
+#include "output_buffer/output_buffer.hpp"
+#include "prefetch/prefetch.hpp"
+#include "problem_index/problem_index.hpp"
+#include "runner/runner.hpp"
+#include "scroll_pane/scroll_pane.hpp"
+#include "source_file/source_file.hpp"
 #include "syntax_highlighting/syntax_highlighting.hpp"
+#include "text_search/text_search.hpp"
+#include "tui/screen_stack.hpp"
 #include "utils/utils.hpp"
 
-void applyBlurEffect() {
-  attron(A_DIM);  // Apply dim attribute
-  for (int i = 0; i < LINES; ++i) {
-    for (int j = 0; j < COLS; ++j) {
-      mvprintw(i, j, " ");  // Fill the screen with spaces to apply dim effect
-    }
-  }
-  attroff(A_DIM);  // Turn off dim attribute
-  refresh();
-}
-
-void TuiSelectAndRun(const std::string& cpp_folder) {
-  std::vector<std::string> problems = ListDirectories(cpp_folder);
-  if (problems.empty()) {
-    std::cerr << "No directories found in " << cpp_folder << std::endl;
-    return;
-  }
-
-  std::string chosen_problem =
-      TuiSelectItem(problems, "Select a Problem", false);
-  std::string chosen_problem_path = cpp_folder + "/" + chosen_problem;
-
-  std::vector<std::string> cpp_files = ListFiles(chosen_problem_path, ".cpp");
-  if (cpp_files.empty()) {
-    std::cerr << "No .cpp files found in " << chosen_problem_path << std::endl;
-    return;
-  }
-
-  std::string chosen_file = TuiSelectItem(cpp_files, "Select a File", true);
-  std::string chosen_file_path = chosen_problem_path + "/" + chosen_file;
-
-  std::string program_output = RunCppFileWithOutput(chosen_file_path);
-  std::string file_content = ReadFileContent(chosen_file_path);
-
-  DisplayCodeAndOutput(file_content, program_output, chosen_file_path);
-}
-
-void drawMenu(WINDOW* menu_win, int highlight,
-              const std::vector<std::string>& items, const std::string& title,
-              bool format_items) {
-  int x = 2, y = 2;
-
+void DrawMenuFrame(WINDOW* menu_win, const std::string& title) {
   wbkgd(menu_win, COLOR_PAIR(4));  // Grey background for the menu
+  werase(menu_win);
   wattron(menu_win, COLOR_PAIR(3));
   mvwprintw(menu_win, 1, 2, "%s", title.c_str());  // Print the title at the top
   wattroff(menu_win, COLOR_PAIR(3));
 
-  for (size_t i = 0; i < items.size(); ++i) {
-    std::string display_name =
-        format_items ? FormatFileName(items[i]) : items[i];
-    if (static_cast<int>(i) == highlight) {
-      wattron(menu_win,
-              A_REVERSE |
-                  COLOR_PAIR(
-                      5));  // Highlight with reverse video and red background
-      mvwprintw(menu_win, y, x, "%s", display_name.c_str());
-      wattroff(menu_win, A_REVERSE | COLOR_PAIR(5));
-    } else {
-      mvwprintw(menu_win, y, x, "%s", display_name.c_str());
-    }
-    y++;
-  }
-
   // Draw borders for the menu
   wattron(menu_win, COLOR_PAIR(1));
   box(menu_win, 0, 0);
   wattroff(menu_win, COLOR_PAIR(1));
-
-  wrefresh(menu_win);
 }
 
-std::string TuiSelectItem(const std::vector<std::string>& items,
-                          const std::string& title, bool format_items) {
-  initscr();
-  clear();
-  noecho();
-  cbreak();
-  curs_set(0);
-  keypad(stdscr, TRUE);
-
-  InitColors();  // Initialize colors
-
-  // Set the entire background to blue
-  bkgd(COLOR_PAIR(1));
-
-  applyBlurEffect();  // Apply blur effect before displaying the selection menu
-
-  int startx = (COLS - 50) / 2;
-  int starty = (LINES - 20) / 2;
-
-  WINDOW* menu_win = newwin(20, 50, starty, startx);
-  keypad(menu_win, TRUE);  // Enable arrow keys for the window
-
-  int highlight = 0;
-  int choice = 0;
-  int c;
-
-  while (1) {
-    drawMenu(menu_win, highlight, items, title, format_items);
-    c = wgetch(menu_win);
-    switch (c) {
-      case 'k':
-      case KEY_UP:
-        if (highlight > 0) highlight--;
-        break;
-      case 'j':
-      case KEY_DOWN:
-        if (highlight < static_cast<int>(items.size() - 1)) highlight++;
-        break;
-      case 10:  // Enter key
-        choice = highlight;
-        break;
-      default:
-        break;
-    }
-    if (c == 10) break;
+void DrawMenuRow(WINDOW* menu_win, int y, const std::string& text,
+                 bool highlighted, const std::string& detail) {
+  int width = getmaxx(menu_win) - 4;
+  int detail_width = std::min(static_cast<int>(detail.size()), width / 2);
+  mvwhline(menu_win, y, 1, ' ', getmaxx(menu_win) - 2);
+  if (highlighted) {
+    // Highlight with reverse video and red background
+    wattron(menu_win, A_REVERSE | COLOR_PAIR(5));
+  }
+  mvwaddnstr(menu_win, y, 2, text.c_str(),
+             detail_width > 0 ? width - detail_width - 1 : width);
+  wattroff(menu_win, A_REVERSE | COLOR_PAIR(5));
+  if (detail_width > 0) {
+    wattron(menu_win, A_DIM);
+    mvwaddnstr(menu_win, y, 2 + width - detail_width, detail.c_str(),
+               detail_width);
+    wattroff(menu_win, A_DIM);
   }
-  endwin();
-
-  return items[choice];
 }
 
 void DrawBottomMenu(WINDOW* bottom_win, int highlight) {
@@ -159,75 +85,72 @@ void DrawBottomMenu(WINDOW* bottom_win, int highlight) {
               menu_items[i].c_str());
     wattroff(bottom_win, A_REVERSE | COLOR_PAIR(5));
   }
-  wrefresh(bottom_win);
+  wnoutrefresh(bottom_win);
 }
 
 void DisplayHelp() {
-  applyBlurEffect();  // Apply blur effect before displaying the help menu
-
-  WINDOW* help_win = newwin(10, 60, (LINES - 10) / 2, (COLS - 60) / 2);
+  // Drawn over the current screen; closing it restores just the cells it
+  // covered
+  Layer help(21, 60, (LINES - 21) / 2, (COLS - 60) / 2);
+  WINDOW* help_win = help.win();
   wbkgd(help_win, COLOR_PAIR(4));  // White background for the help menu
   box(help_win, 0, 0);
   mvwprintw(help_win, 1, 2, "Help Menu:");
   mvwprintw(help_win, 3, 2, "j/k or Arrow Keys: Navigate");
-  mvwprintw(help_win, 4, 2, "Enter: Select");
-  mvwprintw(help_win, 5, 2, "h: Open this help menu");
-  mvwprintw(help_win, 6, 2, "b: Back to previous menu");
-  mvwprintw(help_win, 7, 2, "q: Exit the program");
-  mvwprintw(help_win, 9, 2, "Press any key to close this menu...");
-
-  wrefresh(help_win);
+  mvwprintw(help_win, 4, 2, "g/G, PgUp/PgDn: Jump to top/bottom, page");
+  mvwprintw(help_win, 5, 2, "Enter: Select");
+  mvwprintw(help_win, 6, 2, "/: Filter a menu (Esc clears the filter)");
+  mvwprintw(help_win, 7, 2, "s: Search all solutions' code (problem menu)");
+  mvwprintw(help_win, 8, 2, "a: Run and compare all approaches (file menu)");
+  mvwprintw(help_win, 9, 2, "h: Open this help menu");
+  mvwprintw(help_win, 10, 2, "b: Back to previous menu");
+  mvwprintw(help_win, 11, 2, "m: Benchmark the solution");
+  mvwprintw(help_win, 12, 2, "p: Switch build profile and re-run");
+  mvwprintw(help_win, 13, 2, "x: Benchmark across all build profiles");
+  mvwprintw(help_win, 14, 2, "q: Exit the program");
+  mvwprintw(help_win, 16, 2, "Common std headers are force-included when");
+  mvwprintw(help_win, 17, 2, "compiling; LEETVIEWER_NO_PCH=1 turns that off.");
+  mvwprintw(help_win, 19, 2, "Press any key to close this menu...");
+
+  Compose();
   wgetch(help_win);
-  delwin(help_win);
-
-  // Reset the background to blue after closing the help menu
-  bkgd(COLOR_PAIR(1));
-  clear();
-  refresh();
+  help.Hide();
+  Compose();
 }
 
 bool DisplayConfirmation() {
-  WINDOW* confirm_win = newwin(5, 40, (LINES - 5) / 2, (COLS - 40) / 2);
+  Layer confirm(5, 40, (LINES - 5) / 2, (COLS - 40) / 2);
+  WINDOW* confirm_win = confirm.win();
   wbkgd(confirm_win, COLOR_PAIR(4));
   box(confirm_win, 0, 0);
   mvwprintw(confirm_win, 1, 2, "Are you sure you want to go back? (y/n)");
 
-  wrefresh(confirm_win);
+  Compose();
   int ch = wgetch(confirm_win);
-  delwin(confirm_win);
+  confirm.Hide();
+  Compose();
   return ch == 'y' || ch == 'Y';
 }
 
-void DisplayCodeAndOutput(const std::string& file_content,
-                          const std::string& program_output,
-                          const std::string& file_path) {
-  initscr();
-  noecho();
-  cbreak();
-  keypad(stdscr, TRUE);
+void DrawStatusBar(WINDOW* status_win, bool in_insert_mode,
+                   const RunSession& session) {
+  werase(status_win);
+  mvwprintw(status_win, 0, 2, "Mode: %s",
+            in_insert_mode ? "INSERT " : "COMMAND");
+  mvwprintw(status_win, 0, 20, "%s", session.StatusText().c_str());
+  const std::string& profile = session.profile_name();
+  mvwprintw(status_win, 0,
+            std::max(0, getmaxx(status_win) - static_cast<int>(profile.size()) -
+                            4),
+            "[%s]", profile.c_str());
+  wnoutrefresh(status_win);
+}
 
-  InitColors();  // Initialize colors
 
-  // Set the entire background to blue
-  bkgd(COLOR_PAIR(1));
-  clear();
-  refresh();
-
-  int height = LINES - 6;  // Reserve space for the bottom menu
-  int half_height = height / 2;
-  int width = (COLS / 2) - 2;
-  int startx = 2;
-
-  // Create a window for code, program output, and custom input
-  WINDOW* code_win = newwin(height, width, 1, startx);
-  WINDOW* output_win = newwin(half_height, width, 1, startx + width + 2);
-  WINDOW* input_win =
-      newwin(half_height, width, half_height + 1, startx + width + 2);
-  WINDOW* bottom_win = newwin(3, COLS, LINES - 3, 0);
-  WINDOW* status_win =
-      newwin(1, COLS, 0, 0);  // Status bar window for mode indicator
-
-  // Extract the directory and file name without the .cpp extension
+namespace {
+
+// "two_sum/hash_map.cpp" -> "twosum/hashmap" for window titles
+std::string DisplayName(const std::string& file_path) {
   size_t last_slash = file_path.find_last_of("/\\");
   std::string directory = file_path.substr(0, last_slash);
   std::string file_name = file_path.substr(last_slash + 1);
@@ -243,179 +166,928 @@ void DisplayCodeAndOutput(const std::string& file_content,
   file_name_without_ext.erase(std::remove(file_name_without_ext.begin(),
                                           file_name_without_ext.end(), '_'),
                               file_name_without_ext.end());
+  return directory_name + "/" + file_name_without_ext;
+}
 
-  // Combine directory name and file name for display
-  std::string display_name = directory_name + "/" + file_name_without_ext;
+// Item labels as shown in a menu
+std::vector<std::string> MenuLabels(const std::vector<std::string>& items,
+                                    bool format_items) {
+  std::vector<std::string> labels;
+  labels.reserve(items.size());
+  for (const std::string& item : items) {
+    labels.push_back(format_items ? FormatFileName(item) : item);
+  }
+  return labels;
+}
+
+// A centred menu over the dimmed background. Subclasses decide what
+// choosing an item does.
+//
+// Only the rows inside the viewport are drawn, and moving the highlight
+// within it redraws just the two rows involved, so the menu costs the same
+// for five items or five thousand. "/" starts a fuzzy filter that narrows
+// the list as it is typed.
+class MenuScreen : public Screen {
+ public:
+  MenuScreen(std::vector<std::string> items, const std::string& title,
+             bool format_items)
+      : items_(std::move(items)),
+        title_(title),
+        format_items_(format_items),
+        filter_(MenuLabels(items_, format_items)),
+        menu_(20, 50, (LINES - 20) / 2, (COLS - 50) / 2),
+        rows_(getmaxy(menu_.win()) - 4) {
+    keypad(menu_.win(), TRUE);  // Enable arrow keys for the window
+  }
+
+  WINDOW* input_window() override { return menu_.win(); }
+
+  void Show() override {
+    ShowBackdrop();
+    menu_.Raise();
+    DrawAll();
+  }
+
+  void Hide() override {
+    menu_.Hide();
+    HideBackdrop();
+  }
+
+  Transition HandleKey(int ch) override {
+    if (ch == ERR) {  // Only if a subclass set a timeout
+      OnIdle();
+      return Transition::Stay();
+    }
+    int count = static_cast<int>(filter_.matches().size());
+    switch (ch) {
+      case KEY_UP:
+        MoveTo(highlight_ - 1);
+        break;
+      case KEY_DOWN:
+        MoveTo(highlight_ + 1);
+        break;
+      case KEY_PPAGE:
+        MoveTo(highlight_ - rows_);
+        break;
+      case KEY_NPAGE:
+        MoveTo(highlight_ + rows_);
+        break;
+      default:
+        if (filtering_) {
+          return FilterKey(ch);
+        }
+        switch (ch) {
+          case 'k':
+            MoveTo(highlight_ - 1);
+            break;
+          case 'j':
+            MoveTo(highlight_ + 1);
+            break;
+          case 'g':
+            MoveTo(0);
+            break;
+          case 'G':
+            MoveTo(count - 1);
+            break;
+          case '/':  // Start typing a filter
+            filtering_ = true;
+            DrawFilterLine();
+            break;
+          case 'q':
+            return Transition::Quit();
+          default:
+            return OnKey(ch);
+        }
+        break;
+    }
+    OnDraw();
+    return Transition::Stay();
+  }
 
-  // Draw the top border lower and place the labels inside
-  wbkgd(code_win, COLOR_PAIR(4));
-  box(code_win, 0, 0);
-  mvwprintw(code_win, 0, 2, "Executed %s", display_name.c_str());
+ protected:
+  // Keys other than navigation, filtering and quit.
+  virtual Transition OnKey(int ch) = 0;
+  // Called after the highlight may have moved, e.g. to follow it.
+  virtual void OnDraw() {}
+  // Extra text shown at the right of items()[item]'s row.
+  virtual std::string Detail(int /*item*/) const { return ""; }
+  // Called when no key arrived within the window's timeout.
+  virtual void OnIdle() {}
+
+  const std::vector<std::string>& items() const { return items_; }
+  // Index into items() of the highlighted entry, or of the one `offset`
+  // rows from it; -1 if there is none.
+  int selected(int offset = 0) const {
+    const std::vector<std::uint32_t>& matches = filter_.matches();
+    int position = highlight_ + offset;
+    if (position < 0 || position >= static_cast<int>(matches.size())) {
+      return -1;
+    }
+    return static_cast<int>(matches[position]);
+  }
 
-  wbkgd(output_win, COLOR_PAIR(4));
-  box(output_win, 0, 0);
-  mvwprintw(output_win, 0, 2, "Program Output:");
+  // Replaces the items, keeping the filter query and, if it is still
+  // there, the highlighted item. Takes effect on the next Show() or
+  // Redraw().
+  void SetItems(std::vector<std::string> items) {
+    int chosen = selected();
+    std::string highlighted = chosen >= 0 ? items_[chosen] : "";
+    std::string query = filter_.query();
+    items_ = std::move(items);
+    filter_ = FuzzyFilter(MenuLabels(items_, format_items_));
+    filter_.SetQuery(query);
+    const std::vector<std::uint32_t>& matches = filter_.matches();
+    highlight_ = 0;
+    for (size_t i = 0; i < matches.size(); ++i) {
+      if (items_[matches[i]] == highlighted) {
+        highlight_ = static_cast<int>(i);
+        break;
+      }
+    }
+    top_ = std::clamp(top_, std::max(0, highlight_ - rows_ + 1), highlight_);
+  }
 
-  wbkgd(input_win, COLOR_PAIR(4));
-  box(input_win, 0, 0);
-  mvwprintw(input_win, 0, 2, "Custom Input:");
+  void Redraw() { DrawAll(); }
 
-  // Track the highlight index for the bottom menu
-  int highlight = 0;
+ private:
+  // Keys while the filter line has focus
+  Transition FilterKey(int ch) {
+    std::string query = filter_.query();
+    switch (ch) {
+      case 10:  // Enter chooses the best match
+        filtering_ = false;
+        DrawFilterLine();
+        return OnKey(ch);
+      case 27:  // Escape drops the filter
+        filtering_ = false;
+        query.clear();
+        break;
+      case KEY_BACKSPACE:
+      case 127:
+      case 8:
+        if (!query.empty()) query.pop_back();
+        break;
+      default:
+        if (ch >= 32 && ch < 127) query.push_back(static_cast<char>(ch));
+        break;
+    }
+    if (query != filter_.query()) {
+      filter_.SetQuery(query);
+      highlight_ = 0;
+      top_ = 0;
+      DrawRows();
+    }
+    DrawFilterLine();
+    OnDraw();
+    return Transition::Stay();
+  }
 
-  // Draw the bottom menu
-  DrawBottomMenu(bottom_win, highlight);
+  void MoveTo(int index) {
+    int count = static_cast<int>(filter_.matches().size());
+    index = std::clamp(index, 0, std::max(0, count - 1));
+    if (index == highlight_) return;
+    int previous = highlight_;
+    highlight_ = index;
+    if (index < top_ || index >= top_ + rows_) {
+      // Scroll just far enough to bring the highlight into view
+      top_ = index < top_ ? index : index - rows_ + 1;
+      DrawRows();
+    } else {
+      DrawRow(previous - top_);
+      DrawRow(index - top_);
+      wnoutrefresh(menu_.win());
+    }
+  }
 
-  // Refresh the windows to show the boxes, labels, and initial content
-  wrefresh(code_win);
-  wrefresh(output_win);
-  wrefresh(input_win);
+  void DrawAll() {
+    DrawMenuFrame(menu_.win(), title_);
+    DrawRows();
+    DrawFilterLine();
+    OnDraw();
+  }
 
-  // Set up the content for display
-  int code_start_line = 0;
-  int output_start_line = 0;
-  int max_lines = height - 3;  // Reserve space for borders and labels
+  void DrawRows() {
+    for (int row = 0; row < rows_; ++row) DrawRow(row);
+    if (filter_.matches().empty()) {
+      mvwprintw(menu_.win(), 2, 2, "%s",
+                items_.empty() ? "(nothing to show)" : "(no matches)");
+    }
+    wnoutrefresh(menu_.win());
+  }
 
-  std::vector<std::string> code_lines;
-  std::vector<std::string> output_lines;
-  std::string line;
+  void DrawRow(int row) {
+    const std::vector<std::uint32_t>& matches = filter_.matches();
+    int index = top_ + row;
+    if (index < static_cast<int>(matches.size())) {
+      DrawMenuRow(menu_.win(), row + 2, filter_.candidate(matches[index]),
+                  index == highlight_,
+                  Detail(static_cast<int>(matches[index])));
+    } else {
+      DrawMenuRow(menu_.win(), row + 2, "", false);
+    }
+  }
 
-  std::istringstream ss_code(file_content);
-  while (std::getline(ss_code, line)) {
-    code_lines.push_back(line);
+  // "/query_  12/3000" while filtering, or a hint
+  void DrawFilterLine() {
+    WINDOW* win = menu_.win();
+    int y = getmaxy(win) - 2;
+    mvwhline(win, y, 1, ' ', getmaxx(win) - 2);
+    if (filtering_ || !filter_.query().empty()) {
+      std::string counts = std::to_string(filter_.matches().size()) + "/" +
+                           std::to_string(filter_.size());
+      int query_width = getmaxx(win) - 7 - static_cast<int>(counts.size());
+      mvwprintw(win, y, 2, "/%.*s%s", query_width, filter_.query().c_str(),
+                filtering_ ? "_" : "");
+      mvwprintw(win, y, getmaxx(win) - 2 - static_cast<int>(counts.size()),
+                "%s", counts.c_str());
+    } else {
+      mvwprintw(win, y, 2, "/: filter");
+    }
+    wnoutrefresh(win);
   }
 
-  std::istringstream ss_output(program_output);
-  while (std::getline(ss_output, line)) {
-    output_lines.push_back(line);
+  std::vector<std::string> items_;
+  std::string title_;
+  bool format_items_;
+  FuzzyFilter filter_;  // Over the labels shown for items_
+  Layer menu_;
+  int rows_;           // Item rows in the viewport
+  int highlight_ = 0;  // Position in filter_.matches()
+  int top_ = 0;        // Match shown in the first row
+  bool filtering_ = false;
+};
+
+// Program output next to the code, with a custom-input box and a status
+// bar tracking the background run.
+class CodeViewScreen : public Screen {
+ public:
+  // `remembered_top` keeps the code scroll position for when the same file
+  // is opened again. Finished runs are recorded in `index`.
+  CodeViewScreen(ProblemIndex* index, const std::string& file_path,
+                 int* remembered_top)
+      : index_(index),
+        file_path_(file_path),
+        remembered_top_(remembered_top),
+        // Compile and run in the background so the code renders immediately
+        session_(std::make_unique<RunSession>(file_path)),
+        height_(LINES - 6),  // Reserve space for the bottom menu
+        half_height_(height_ / 2),
+        width_((COLS / 2) - 2),
+        max_lines_(height_ - 3),  // Reserve space for borders and labels
+        code_layer_(height_, width_, 1, 2),
+        output_layer_(half_height_, width_, 1, width_ + 4),
+        input_layer_(half_height_, width_, half_height_ + 1, width_ + 4),
+        bottom_layer_(3, COLS, LINES - 3, 0),
+        status_layer_(1, COLS, 0, 0),  // Mode and run status
+        code_win_(code_layer_.win()),
+        output_win_(output_layer_.win()),
+        input_win_(input_layer_.win()),
+        bottom_win_(bottom_layer_.win()),
+        status_win_(status_layer_.win()),
+        code_(OpenSourceFile(file_path)),
+        missing_(&kMissingFile),
+        code_source_(code_ ? static_cast<LineSource*>(code_.get())
+                           : &missing_),
+        code_pane_(code_win_, "Executed " + DisplayName(file_path), max_lines_,
+                   true),
+        output_pane_(output_win_, "Program Output:", half_height_ - 2),
+        drawn_stage_(session_->stage()) {
+    wbkgd(code_win_, COLOR_PAIR(4));
+    wbkgd(output_win_, COLOR_PAIR(4));
+    wbkgd(input_win_, COLOR_PAIR(4));
+    keypad(code_win_, TRUE);  // Arrow and page keys arrive as KEY_* codes
+    // Poll for keys with a timeout so streamed output and progress keep
+    // flowing
+    wtimeout(code_win_, 50);
+
+    code_pane_.ScrollTo(std::clamp(*remembered_top_, 0, LastTop()));
   }
 
-  // Display the initial lines of code and output with syntax highlighting
-  DisplayScrollableContent(code_win, code_lines, code_start_line, max_lines);
-  DisplayScrollableContent(output_win, output_lines, output_start_line,
-                           half_height - 2);
+  ~CodeViewScreen() override { *remembered_top_ = code_pane_.top(); }
+
+  CodeViewScreen(const CodeViewScreen&) = delete;
+  CodeViewScreen& operator=(const CodeViewScreen&) = delete;
 
-  std::string input_text;
-  bool in_insert_mode = false;
-  int ch;
+  WINDOW* input_window() override { return code_win_; }
 
-  // Display the initial status
-  mvwprintw(status_win, 0, 2, "Mode: COMMAND");
-  wrefresh(status_win);
+  void Show() override {
+    for (Layer* layer : {&code_layer_, &output_layer_, &input_layer_,
+                         &bottom_layer_, &status_layer_}) {
+      layer->Raise();
+    }
+    DrawBottomMenu(bottom_win_, 0);
+    Render();
+  }
 
-  while ((ch = wgetch(code_win)) != 'q') {
+  void Hide() override {
+    for (Layer* layer : {&code_layer_, &output_layer_, &input_layer_,
+                         &bottom_layer_, &status_layer_}) {
+      layer->Hide();
+    }
+  }
+
+  // Each pass updates the model, then renders only what changed.
+  Transition HandleKey(int ch) override {
     switch (ch) {
+      case ERR: {  // No key: pick up output and progress
+        std::string chunk;
+        if (session_->TakeOutput(&chunk)) {
+          output_pane_.MarkChanged(static_cast<int>(output_.FirstOpenLine()));
+          output_.Append(chunk);
+          status_dirty_ = true;
+        }
+        // The spinner moves while busy; the final state is drawn once
+        RunStage stage = session_->stage();
+        status_dirty_ = status_dirty_ || stage != drawn_stage_ ||
+                        stage == RunStage::kCompiling ||
+                        stage == RunStage::kRunning;
+        drawn_stage_ = stage;
+        ProcessResult result;
+        if (!run_recorded_ && session_->FinishedRun(&result)) {
+          index_->RecordRun(file_path_, result);
+          run_recorded_ = true;
+        }
+        break;
+      }
+      case 'q':
+        return Transition::Quit();
       case 'k':
       case KEY_UP:
-        if (!in_insert_mode) {
-          if (code_start_line > 0) code_start_line--;
-          if (output_start_line > 0) output_start_line--;
+        if (!in_insert_mode_) {
+          if (code_pane_.top() > 0) code_pane_.ScrollTo(code_pane_.top() - 1);
+          if (output_pane_.top() > 0) {
+            output_pane_.ScrollTo(output_pane_.top() - 1);
+          }
         }
         break;
       case 'j':
       case KEY_DOWN:
-        if (!in_insert_mode) {
-          if (code_start_line + max_lines < static_cast<int>(code_lines.size()))
-            code_start_line++;
-          if (output_start_line + half_height - 2 <
-              static_cast<int>(output_lines.size()))
-            output_start_line++;
+        if (!in_insert_mode_) {
+          if (code_pane_.top() < LastTop())
+            code_pane_.ScrollTo(code_pane_.top() + 1);
+          if (output_.HasLine(output_pane_.top() +
+                              output_pane_.visible_lines()))
+            output_pane_.ScrollTo(output_pane_.top() + 1);
+        }
+        break;
+      case 'g':  // Jump to the top of the code
+      case 'G':  // Jump to the bottom of the code
+      case KEY_PPAGE:
+      case KEY_NPAGE:
+        if (!in_insert_mode_) {
+          int top = ch == 'g'         ? 0
+                    : ch == 'G'       ? LastTop()
+                    : ch == KEY_PPAGE ? code_pane_.top() - max_lines_
+                                      : code_pane_.top() + max_lines_;
+          code_pane_.ScrollTo(std::clamp(top, 0, LastTop()));
         }
         break;
       case 'h':  // Help
-        if (!in_insert_mode) {
-          DisplayHelp();
-
-          // Reset the background to blue and refresh all windows
-          bkgd(COLOR_PAIR(1));
-          clear();
-          refresh();
-          wrefresh(code_win);
-          wrefresh(output_win);
-          wrefresh(input_win);
-          DrawBottomMenu(bottom_win, highlight);
+        if (!in_insert_mode_) DisplayHelp();
+        break;
+      case 'b':  // Back to the file list
+        if (!in_insert_mode_ && DisplayConfirmation()) {
+          return Transition::Pop();
         }
         break;
-      case 'b':  // Back
-        if (!in_insert_mode) {
-          if (DisplayConfirmation()) {  // Add confirmation before going back
-            endwin();
-            TuiSelectAndRun(
-                GetCurrentWorkingDir());  // Restart folder selection
-                                          // with current directory
-            return;  // Exit the function to prevent continuing in current
-                     // context
-          }
+      case 'm':  // Benchmark the solution
+        if (!in_insert_mode_) Restart(RunMode::kBenchmark);
+        break;
+      case 'p':  // Switch to the next build profile and re-run
+        if (!in_insert_mode_) {
+          CycleActiveBuildProfile();
+          Restart(RunMode::kRun);
         }
         break;
+      case 'x':  // Benchmark the solution under every build profile
+        if (!in_insert_mode_) Restart(RunMode::kMatrix);
+        break;
       case 'i':  // Enter insert mode (Vim-like)
-        in_insert_mode = true;
-        mvwprintw(status_win, 0, 2, "Mode: INSERT ");
-        wrefresh(status_win);
+        in_insert_mode_ = true;
+        status_dirty_ = true;
         break;
       case 27:  // Escape key to exit insert mode (Vim-like)
-        in_insert_mode = false;
-        mvwprintw(status_win, 0, 2, "Mode: COMMAND");
-        wrefresh(status_win);
+        in_insert_mode_ = false;
+        status_dirty_ = true;
         break;
       case 'o':  // Exit and run the code
-        if (!in_insert_mode) {
+        if (!in_insert_mode_) {
           // Process the input here
-          mvwprintw(input_win, 1, 2, "Input accepted: %s", input_text.c_str());
-          input_text.clear();
+          input_notice_ = "Input accepted: " + input_text_;
+          input_text_.clear();
+          input_dirty_ = true;
         }
         break;
       default:
-        if (in_insert_mode) {
-          input_text.push_back(ch);
-          mvwprintw(input_win, 1, 2, "%s", input_text.c_str());
+        if (in_insert_mode_) {
+          input_text_.push_back(ch);
+          input_dirty_ = true;
         }
         break;
     }
+    Render();
+    return Transition::Stay();
+  }
 
-    // Clear the windows and redraw the visible lines with syntax highlighting
-    werase(code_win);
-    werase(output_win);
-    werase(input_win);
-    box(code_win, 0, 0);
-    mvwprintw(code_win, 0, 2, "Executed %s: ",
-              display_name.c_str());  // Redraw label inside the box
-    box(output_win, 0, 0);
-    mvwprintw(output_win, 0, 2,
-              "Program Output:");  // Redraw label inside the box
-    box(input_win, 0, 0);
-    mvwprintw(input_win, 0, 2, "Custom Input:");
+ private:
+  int LastTop() const {
+    int lines = code_ ? static_cast<int>(code_->line_count()) : 1;
+    return std::max(0, lines - max_lines_);
+  }
 
-    DisplayScrollableContent(code_win, code_lines, code_start_line, max_lines);
-    DisplayScrollableContent(output_win, output_lines, output_start_line,
-                             half_height - 2);
-    mvwprintw(input_win, 1, 2, "%s", input_text.c_str());
+  // Starts a new session whose output replaces the current one
+  void Restart(RunMode mode) {
+    session_ = std::make_unique<RunSession>(file_path_, mode);
+    run_recorded_ = false;
+    output_.Clear();
+    output_pane_.ScrollTo(0);
+    output_pane_.MarkChanged(0);
+    status_dirty_ = true;
+  }
 
-    wrefresh(code_win);
-    wrefresh(output_win);
-    wrefresh(input_win);
+  // Stages whatever changed with wnoutrefresh
+  void Render() {
+    code_pane_.Render(code_source_);
+    output_pane_.Render(&output_);
+    if (input_dirty_) {
+      werase(input_win_);
+      box(input_win_, 0, 0);
+      mvwprintw(input_win_, 0, 2, "Custom Input:");
+      mvwprintw(input_win_, 1, 2, "%s",
+                (input_notice_.empty() ? input_text_ : input_notice_).c_str());
+      wnoutrefresh(input_win_);
+      input_notice_.clear();
+      input_dirty_ = false;
+    }
+    if (status_dirty_) {
+      DrawStatusBar(status_win_, in_insert_mode_, *session_);
+      status_dirty_ = false;
+    }
   }
 
-  endwin();
-}
+  ProblemIndex* index_;
+  std::string file_path_;
+  int* remembered_top_;
+  std::unique_ptr<RunSession> session_;
+  bool run_recorded_ = false;  // session_'s outcome is in index_
+  int height_;
+  int half_height_;
+  int width_;
+  int max_lines_;
+  Layer code_layer_;
+  Layer output_layer_;
+  Layer input_layer_;
+  Layer bottom_layer_;
+  Layer status_layer_;
+  WINDOW* code_win_;
+  WINDOW* output_win_;
+  WINDOW* input_win_;
+  WINDOW* bottom_win_;
+  WINDOW* status_win_;
+  static inline const std::vector<std::string> kMissingFile = {
+      "Error opening file!"};
+  // Shared with other views of the same file, and kept loaded for a while
+  // after this one closes
+  std::shared_ptr<SourceFile> code_;
+  StringLines missing_;  // Shown if the file could not be opened
+  LineSource* code_source_;
+  OutputBuffer output_;  // Can grow far beyond what fits in memory
+  ScrollPane code_pane_;
+  ScrollPane output_pane_;
+  std::string input_text_;
+  std::string input_notice_;  // Shown in place of the input until next key
+  bool input_dirty_ = true;
+  bool in_insert_mode_ = false;
+  bool status_dirty_ = true;
+  RunStage drawn_stage_;
+};
+
+// Ranked benchmark of every approach in a problem directory.
+class ComparisonScreen : public Screen {
+ public:
+  ComparisonScreen(const std::string& problem_path,
+                   const std::vector<std::string>& cpp_files)
+      // Compile and benchmark every approach in the background
+      : session_(problem_path, cpp_files),
+        table_layer_(LINES - 6, COLS - 4, 1, 2),
+        bottom_layer_(3, COLS, LINES - 3, 0),
+        status_layer_(1, COLS, 0, 0),
+        table_win_(table_layer_.win()),
+        bottom_win_(bottom_layer_.win()),
+        status_win_(status_layer_.win()),
+        table_pane_(table_win_,
+                    "Run all: " + problem_path.substr(
+                                      problem_path.find_last_of("/\\") + 1),
+                    LINES - 8) {
+    wbkgd(table_win_, COLOR_PAIR(4));
+    keypad(table_win_, TRUE);
+    wtimeout(table_win_, 50);
+  }
+
+  ComparisonScreen(const ComparisonScreen&) = delete;
+  ComparisonScreen& operator=(const ComparisonScreen&) = delete;
+
+  WINDOW* input_window() override { return table_win_; }
+
+  void Show() override {
+    for (Layer* layer : {&table_layer_, &bottom_layer_, &status_layer_}) {
+      layer->Raise();
+    }
+    DrawBottomMenu(bottom_win_, 0);
+    Render();
+  }
+
+  void Hide() override {
+    for (Layer* layer : {&table_layer_, &bottom_layer_, &status_layer_}) {
+      layer->Hide();
+    }
+  }
+
+  Transition HandleKey(int ch) override {
+    switch (ch) {
+      case 'q':
+        return Transition::Quit();
+      case 'k':
+      case KEY_UP:
+        if (table_pane_.top() > 0) table_pane_.ScrollTo(table_pane_.top() - 1);
+        break;
+      case 'j':
+      case KEY_DOWN:
+        if (table_.HasLine(table_pane_.top() + table_pane_.visible_lines()))
+          table_pane_.ScrollTo(table_pane_.top() + 1);
+        break;
+      case 'h':  // Help
+        DisplayHelp();
+        break;
+      case 'b':  // Back to the file list
+        if (DisplayConfirmation()) return Transition::Pop();
+        break;
+      default:
+        break;
+    }
+    Render();
+    return Transition::Stay();
+  }
+
+ private:
+  void Render() {
+    std::string chunk;
+    if (session_.TakeOutput(&chunk)) {
+      table_pane_.MarkChanged(static_cast<int>(table_.FirstOpenLine()));
+      table_.Append(chunk);
+    }
+    table_pane_.Render(&table_);
+    DrawStatusBar(status_win_, false, session_);
+  }
+
+  RunSession session_;
+  Layer table_layer_;
+  Layer bottom_layer_;
+  Layer status_layer_;
+  WINDOW* table_win_;
+  WINDOW* bottom_win_;
+  WINDOW* status_win_;
+  OutputBuffer table_;
+  ScrollPane table_pane_;
+};
+
+// The .cpp files of one problem. The highlighted file and its neighbours
+// are compiled in the background while the menu is open.
+class FileListScreen : public MenuScreen {
+ public:
+  FileListScreen(ProblemIndex* index, const std::string& problem_path,
+                 std::vector<std::string> cpp_files)
+      : MenuScreen(std::move(cpp_files), "Select a File (a: run all, b: back)",
+                   true),
+        index_(index),
+        problem_path_(problem_path),
+        code_tops_(items().size(), 0) {}
+
+  void Show() override {
+    prefetched_ = -1;  // Resume prefetching after a run
+    MenuScreen::Show();
+  }
+
+ protected:
+  Transition OnKey(int ch) override {
+    if (items().empty() && ch != 'b') return Transition::Stay();
+    switch (ch) {
+      case 10: {  // Enter key
+        int chosen = selected();
+        if (chosen < 0) return Transition::Stay();
+        // Keep only the chosen file's compile; the run will wait for it
+        std::string path = problem_path_ + "/" + items()[chosen];
+        prefetcher_.Prefetch({path});
+        return Transition::Push(std::make_unique<CodeViewScreen>(
+            index_, path, &code_tops_[chosen]));
+      }
+      case 'a':  // Run every file instead of picking one
+        prefetcher_.Prefetch({});
+        return Transition::Push(
+            std::make_unique<ComparisonScreen>(problem_path_, items()));
+      case 'b':
+        return Transition::Pop();
+      default:
+        return Transition::Stay();
+    }
+  }
+
+  void OnDraw() override {
+    if (selected() < 0 || prefetched_ == selected()) return;
+    // Compile the highlighted file first, then the ones next to it
+    std::vector<std::string> wanted;
+    for (int offset : {0, 1, -1}) {
+      int i = selected(offset);
+      if (i >= 0) wanted.push_back(problem_path_ + "/" + items()[i]);
+    }
+    prefetcher_.Prefetch(wanted);
+    prefetched_ = selected();
+  }
+
+  // How the last run went: "1.20 ms", "exit 1" or "signal 11"
+  std::string Detail(int item) const override {
+    SolutionFile file;
+    if (!index_->Lookup(problem_path_ + "/" + items()[item], &file) ||
+        file.last_run.finished_at == 0) {
+      return "";
+    }
+    const RunRecord& run = file.last_run;
+    if (run.term_signal != 0) {
+      return "signal " + std::to_string(run.term_signal);
+    }
+    if (run.exit_code != 0) return "exit " + std::to_string(run.exit_code);
+    return FormatNanoseconds(static_cast<double>(run.wall_ns));
+  }
+
+ private:
+  ProblemIndex* index_;
+  std::string problem_path_;
+  CompilePrefetcher prefetcher_;
+  int prefetched_ = -1;
+  std::vector<int> code_tops_;  // Code view scroll position per file
+};
+
+// Full-text search over every solution. Typing edits the query and the
+// results follow each key; Enter opens the highlighted file at its first
+// match.
+class SearchScreen : public Screen {
+ public:
+  SearchScreen(ProblemIndex* index, TextSearch* search,
+               const std::string& cpp_folder)
+      : index_(index),
+        search_(search),
+        cpp_folder_(cpp_folder),
+        layer_(LINES - 4, COLS - 8, 2, 4),
+        rows_(getmaxy(layer_.win()) - 5) {
+    keypad(layer_.win(), TRUE);
+    // Poll so results fill in while the index is still being built
+    wtimeout(layer_.win(), 100);
+  }
+
+  WINDOW* input_window() override { return layer_.win(); }
+
+  void Show() override {
+    ShowBackdrop();
+    layer_.Raise();
+    Draw();
+  }
+
+  void Hide() override {
+    layer_.Hide();
+    HideBackdrop();
+  }
+
+  Transition HandleKey(int ch) override {
+    switch (ch) {
+      case ERR:
+        if (search_->indexed_files() != searched_files_ ||
+            search_->ready() != searched_ready_) {
+          Search(false);
+        }
+        break;
+      case 27:  // Escape
+        return Transition::Pop();
+      case KEY_UP:
+        MoveTo(selected_ - 1);
+        break;
+      case KEY_DOWN:
+        MoveTo(selected_ + 1);
+        break;
+      case KEY_PPAGE:
+        MoveTo(selected_ - 5);
+        break;
+      case KEY_NPAGE:
+        MoveTo(selected_ + 5);
+        break;
+      case 10: {  // Enter key
+        if (hits_.empty()) break;
+        const SearchHit& hit = hits_[selected_];
+        // Open with the first match a few lines from the top
+        int& top = code_tops_[hit.path];
+        if (!hit.lines.empty()) top = std::max(0, hit.lines[0].number - 3);
+        return Transition::Push(std::make_unique<CodeViewScreen>(
+            index_, cpp_folder_ + "/" + hit.path, &top));
+      }
+      case KEY_BACKSPACE:
+      case 127:
+      case 8:
+        if (!query_.empty()) {
+          query_.pop_back();
+          Search(true);
+        }
+        break;
+      default:
+        if (ch >= 32 && ch < 127) {
+          query_.push_back(static_cast<char>(ch));
+          Search(true);
+        }
+        break;
+    }
+    return Transition::Stay();
+  }
+
+ private:
+  static constexpr size_t kMaxHits = 200;
+  static constexpr size_t kLinesPerHit = 3;
+
+  void Search(bool from_top) {
+    searched_files_ = search_->indexed_files();
+    searched_ready_ = search_->ready();
+    hits_ = search_->Search(query_, kMaxHits);
+    lines_found_.assign(hits_.size(), false);
+    if (from_top) {
+      selected_ = 0;
+      top_ = 0;
+    }
+    MoveTo(selected_);
+  }
+
+  // Rows taken by hits_[hit]: its path and its matching lines
+  int HitRows(int hit) {
+    if (!lines_found_[hit]) {
+      // Only hits that come into view are read
+      search_->FindLines(query_, kLinesPerHit, &hits_[hit]);
+      lines_found_[hit] = true;
+    }
+    return 1 + static_cast<int>(hits_[hit].lines.size());
+  }
+
+  void MoveTo(int hit) {
+    int count = static_cast<int>(hits_.size());
+    selected_ = std::clamp(hit, 0, std::max(0, count - 1));
+    top_ = std::min(top_, selected_);
+    // Scroll down until the whole selected hit fits
+    auto rows_used = [&]() {
+      int rows = 0;
+      for (int i = top_; i <= selected_; ++i) rows += HitRows(i);
+      return rows;
+    };
+    while (top_ < selected_ && rows_used() > rows_) ++top_;
+    Draw();
+  }
+
+  void Draw() {
+    WINDOW* win = layer_.win();
+    int width = getmaxx(win) - 4;
+    DrawMenuFrame(win, "Search all solutions (Enter: open, Esc: back)");
+    std::string files = std::to_string(searched_files_) + " files";
+    if (!searched_ready_) files = "indexing, " + files;
+    mvwprintw(win, 2, 2, "> %.*s_", width - 4 - static_cast<int>(files.size()),
+              query_.c_str());
+    mvwprintw(win, 2, getmaxx(win) - 2 - static_cast<int>(files.size()), "%s",
+              files.c_str());
+    mvwhline(win, 3, 1, ACS_HLINE, getmaxx(win) - 2);
+
+    int y = 4;
+    int last = getmaxy(win) - 2;
+    if (hits_.empty()) {
+      mvwprintw(win, y, 2, "%s",
+                query_.empty() ? "(type to search)" : "(no matches)");
+    }
+    for (int i = top_; i < static_cast<int>(hits_.size()) && y <= last; ++i) {
+      HitRows(i);
+      const SearchHit& hit = hits_[i];
+      DrawMenuRow(win, y++, hit.path, i == selected_,
+                  std::to_string(hit.match_count) +
+                      (hit.match_count == 1 ? " line" : " lines"));
+      for (const SearchLine& line : hit.lines) {
+        if (y > last) break;
+        DrawMatchLine(win, y++, line, width);
+      }
+    }
+    wnoutrefresh(win);
+  }
 
-void DisplayScrollableContent(WINDOW* win,
-                              const std::vector<std::string>& content,
-                              int start_line, int max_lines) {
-  int line_num = 1;  // Starting line for content display
-  for (int i = 0;
-       i < max_lines && (i + start_line) < static_cast<int>(content.size());
-       ++i) {
-    std::string line = content[i + start_line];
+  // "   42  text" with the matches picked out
+  static void DrawMatchLine(WINDOW* win, int y, const SearchLine& line,
+                            int width) {
+    char number[16];
+    snprintf(number, sizeof(number), "%6d  ", line.number + 1);
+    mvwaddstr(win, y, 2, number);
+    int room = width - static_cast<int>(strlen(number));
+    int column = 0;
+    for (const auto& [begin, end] : line.matches) {
+      if (begin < column) continue;
+      waddnstr(win, line.text.c_str() + column,
+               std::max(0, std::min(begin, room) - column));
+      wattron(win, A_BOLD | COLOR_PAIR(12));
+      waddnstr(win, line.text.c_str() + begin,
+               std::max(0, std::min(end, room) - begin));
+      wattroff(win, A_BOLD | COLOR_PAIR(12));
+      column = end;
+    }
+    int rest = std::min(static_cast<int>(line.text.size()), room) - column;
+    if (rest > 0) waddnstr(win, line.text.c_str() + column, rest);
+  }
 
-    // Apply syntax highlighting for the entire line
-    HighlightSyntax(win, line, line_num);
+  ProblemIndex* index_;
+  TextSearch* search_;
+  std::string cpp_folder_;
+  Layer layer_;
+  int rows_;  // Rows available for hits
+  std::string query_;
+  std::vector<SearchHit> hits_;
+  std::vector<bool> lines_found_;  // Per hit, whether FindLines() ran
+  int selected_ = 0;  // Highlighted hit
+  int top_ = 0;       // Hit shown first
+  size_t searched_files_ = 0;  // Index state the hits were found with
+  bool searched_ready_ = false;
+  std::map<std::string, int> code_tops_;  // Code view position per file
+};
+
+// The problem directories under the working directory.
+class ProblemListScreen : public MenuScreen {
+ public:
+  ProblemListScreen(ProblemIndex* index, TextSearch* search,
+                    const std::string& cpp_folder)
+      : MenuScreen(index->Problems(), "Select a Problem (s: search code)",
+                   false),
+        index_(index),
+        search_(search),
+        cpp_folder_(cpp_folder),
+        shown_version_(index->version()) {
+    // Wake up now and then to take in problems as the index finds them
+    wtimeout(input_window(), 200);
+  }
 
-    line_num++;
-    if (line_num > max_lines) {
-      break;
+  void Show() override {
+    // Pick up problems added or removed while a problem was open
+    TakeProblems();
+    MenuScreen::Show();
+  }
+
+ protected:
+  Transition OnKey(int ch) override {
+    if (ch == 's') {
+      return Transition::Push(
+          std::make_unique<SearchScreen>(index_, search_, cpp_folder_));
     }
+    if (ch != 10 || selected() < 0) return Transition::Stay();  // Enter
+    const std::string& problem = items()[selected()];
+    return Transition::Push(std::make_unique<FileListScreen>(
+        index_, cpp_folder_ + "/" + problem, index_->Files(problem)));
+  }
+
+  void OnIdle() override {
+    if (index_->version() == shown_version_) return;
+    if (TakeProblems()) Redraw();
   }
 
-  wrefresh(win);
+ private:
+  // Returns true if the list changed
+  bool TakeProblems() {
+    shown_version_ = index_->version();
+    std::vector<std::string> problems = index_->Problems();
+    if (problems == items()) return false;
+    SetItems(std::move(problems));
+    return true;
+  }
+
+  ProblemIndex* index_;
+  TextSearch* search_;
+  std::string cpp_folder_;
+  std::uint64_t shown_version_;  // Index version the items were taken at
+};
+
+}  // namespace
+
+TuiSession::TuiSession() {
+  initscr();
+  noecho();
+  cbreak();
+  curs_set(0);
+  keypad(stdscr, TRUE);
+  set_escdelay(25);  // Esc leaves insert and filter modes without a pause
+  InitColors();
+  bkgd(COLOR_PAIR(1));
+}
+
+TuiSession::~TuiSession() { endwin(); }
+
+void TuiSelectAndRun(const std::string& cpp_folder) {
+  // Kept up to date in the background while the menus are in use
+  ProblemIndex index(cpp_folder);
+  TextSearch search(cpp_folder, &index);  // Indexes contents on first use
+  RunScreenStack(
+      std::make_unique<ProblemListScreen>(&index, &search, cpp_folder));
 }
@@ -7,22 +7,30 @@
 #include <string>
 #include <vector>
 
+// Owns the terminal for the whole program: curses is initialised and the
+// colour pairs are set up once, and the terminal is restored on
+// destruction.
+class TuiSession {
+ public:
+  TuiSession();
+  ~TuiSession();
+
+  TuiSession(const TuiSession&) = delete;
+  TuiSession& operator=(const TuiSession&) = delete;
+};
+
+// Problem list -> file list -> code view (or comparison), as a stack of
+// screens in the current TuiSession. Returns when the user quits.
 void TuiSelectAndRun(const std::string& cpp_folder);
-void DrawMenu(WINDOW* menu_win, int highlight,
-              const std::vector<std::string>& items, const std::string& title,
-              bool format_items = false);
-std::string TuiSelectItem(const std::vector<std::string>& items,
-                          const std::string& title, bool format_items = false);
-void DisplayCodeAndOutput(const std::string& file_content,
-                          const std::string& program_output,
-                          const std::string& file_path);
-void DisplayScrollableContent(WINDOW* win,
-                              const std::vector<std::string>& content,
-                              int start_line, int max_lines);
+// Background, title and border of a menu window.
+void DrawMenuFrame(WINDOW* menu_win, const std::string& title);
+// One item of a menu on row `y`, clipped to the window, with `detail` (if
+// any) right-aligned after it.
+void DrawMenuRow(WINDOW* menu_win, int y, const std::string& text,
+                 bool highlighted, const std::string& detail = "");
 void DrawBottomMenu(WINDOW* bottom_win, int highlight);
 void DisplayHelp();
 bool DisplayConfirmation();
 void InitColors();
-void ApplyBlurEffect();
 
 #endif  // SRC_TUI_TUI_HPP_
@@ -1,7 +1,12 @@
 // Copyright 2024 Keys
 #include "utils/utils.hpp"
 
+#include <sys/stat.h>
+
 #include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
 #include <string>
 
 std::string FormatFileName(const std::string& file_name) {
@@ -10,3 +15,47 @@ std::string FormatFileName(const std::string& file_name) {
   std::replace(base_name.begin(), base_name.end(), '_', ' ');
   return base_name + " iteration";  // Append " iteration" to the base name
 }
+
+std::string GetEnvOr(const char* name, const std::string& fallback) {
+  const char* value = std::getenv(name);
+  if (value == nullptr || *value == '\0') {
+    return fallback;
+  }
+  return value;
+}
+
+long GetEnvLong(const char* name, long fallback) {  // NOLINT [runtime/int]
+  const char* value = std::getenv(name);
+  if (value == nullptr || *value == '\0') {
+    return fallback;
+  }
+  char* end = nullptr;
+  long parsed = std::strtol(value, &end, 10);  // NOLINT [runtime/int]
+  return (end != value && *end == '\0') ? parsed : fallback;
+}
+
+std::string FormatBytes(double bytes) {
+  static const char* kUnits[] = {"B", "KB", "MB", "GB", "TB"};
+  int unit = 0;
+  while (bytes >= 1024 && unit < 4) {
+    bytes /= 1024;
+    unit++;
+  }
+  char buffer[32];
+  snprintf(buffer, sizeof(buffer), unit == 0 ? "%.0f %s" : "%.2f %s", bytes,
+           kUnits[unit]);
+  return buffer;
+}
+
+bool MakeDirectories(const std::string& path) {
+  for (size_t pos = 1; pos <= path.size(); ++pos) {
+    if (pos != path.size() && path[pos] != '/') {
+      continue;
+    }
+    std::string prefix = path.substr(0, pos);
+    if (mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST) {
+      return false;
+    }
+  }
+  return true;
+}
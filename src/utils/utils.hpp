@@ -6,4 +6,14 @@
 
 std::string FormatFileName(const std::string& file_name);
 
+// Environment lookups with a fallback for unset or empty variables.
+std::string GetEnvOr(const char* name, const std::string& fallback);
+long GetEnvLong(const char* name, long fallback);  // NOLINT [runtime/int]
+
+// "512 B", "12.3 KB", "4.50 MB", ...
+std::string FormatBytes(double bytes);
+
+// Creates `path` and any missing parents; returns false on failure.
+bool MakeDirectories(const std::string& path);
+
 #endif  // SRC_UTILS_UTILS_HPP_